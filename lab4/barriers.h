@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <vector>
+
+//многоразовые барьеры для фазовой синхронизации. У всех один интерфейс:
+//arriveAndWait(thread) с номером потока 0..threads-1. Ожидание - вращение
+//на флаге, после SPIN_LIMIT неудачных проверок с уступкой процессора:
+//потоков может быть больше, чем ядер
+
+namespace barrier_detail {
+    constexpr int SPIN_LIMIT = 128;
+
+    template <typename Predicate>
+    void spinUntil(Predicate done) {
+        for (int spins = 0; !done(); ++spins) {
+            if (spins >= SPIN_LIMIT) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    struct alignas(64) PaddedFlag {
+        bool value = true;
+    };
+}
+
+//std::barrier под общим интерфейсом, для сравнения
+class StdBarrier {
+private:
+    std::barrier<> phase;
+
+public:
+    explicit StdBarrier(int threads) : phase(threads) {}
+    void arriveAndWait(int) { phase.arrive_and_wait(); }
+};
+
+//централизованный барьер с обращением смысла: общий счётчик прибытий,
+//последний прибывший сбрасывает счётчик и переворачивает общий флаг.
+//Все ждущие крутятся на одной кэш-линии, поэтому плохо растёт с числом ядер
+class SenseBarrier {
+private:
+    int numThreads;
+    alignas(64) std::atomic<int> remaining;
+    alignas(64) std::atomic<bool> sense{false};
+    std::vector<barrier_detail::PaddedFlag> localSense;
+
+public:
+    explicit SenseBarrier(int threads) : numThreads(threads), remaining(threads), localSense(threads) {}
+
+    void arriveAndWait(int thread) {
+        bool mySense = localSense[thread].value;
+        localSense[thread].value = !mySense;
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining.store(numThreads, std::memory_order_relaxed);
+            sense.store(mySense, std::memory_order_release);
+            return;
+        }
+        barrier_detail::spinUntil([&] { return sense.load(std::memory_order_acquire) == mySense; });
+    }
+};
+
+//барьер распространения: за раунд r поток сигналит потоку (thread + 2^r) mod n
+//и ждёт сигнала от (thread - 2^r) mod n, всего ceil(log2 n) раундов без общего
+//счётчика. Флаги двух чётностей позволяют сразу начать следующую фазу
+class DisseminationBarrier {
+private:
+    static constexpr int MAX_ROUNDS = 16;    //до 65536 потоков
+
+    struct alignas(64) Node {
+        std::atomic<bool> flags[2][MAX_ROUNDS] = {};
+        int parity = 0;
+        bool sense = true;
+    };
+
+    int numThreads;
+    int rounds = 0;
+    std::vector<Node> nodes;
+
+public:
+    explicit DisseminationBarrier(int threads) : numThreads(threads), nodes(threads) {
+        while ((1 << rounds) < threads) {
+            ++rounds;
+        }
+    }
+
+    void arriveAndWait(int thread) {
+        Node& me = nodes[thread];
+        for (int r = 0; r < rounds; ++r) {
+            Node& partner = nodes[(thread + (1 << r)) % numThreads];
+            partner.flags[me.parity][r].store(me.sense, std::memory_order_release);
+            barrier_detail::spinUntil([&] {
+                return me.flags[me.parity][r].load(std::memory_order_acquire) == me.sense;
+            });
+        }
+        if (me.parity == 1) {
+            me.sense = !me.sense;
+        }
+        me.parity = 1 - me.parity;
+    }
+};
+
+//турнирный барьер: в раунде k поток с нулевыми младшими k+1 битами ждёт
+//прибытия соперника thread + 2^k, а соперник сообщает о себе и выбывает.
+//Победитель турнира (поток 0) освобождает проигравших по тому же дереву
+//в обратном порядке. Каждый поток крутится только на своих флагах
+class TournamentBarrier {
+private:
+    static constexpr int MAX_ROUNDS = 16;
+
+    struct alignas(64) Node {
+        std::atomic<bool> arrived[MAX_ROUNDS] = {};
+        std::atomic<bool> release{false};
+        bool sense = true;
+    };
+
+    int numThreads;
+    std::vector<Node> nodes;
+
+public:
+    explicit TournamentBarrier(int threads) : numThreads(threads), nodes(threads) {}
+
+    void arriveAndWait(int thread) {
+        Node& me = nodes[thread];
+        bool sense = me.sense;
+        me.sense = !sense;
+
+        int round = 0;
+        for (; (1 << round) < numThreads; ++round) {
+            int bit = 1 << round;
+            if (thread & bit) {
+                nodes[thread - bit].arrived[round].store(sense, std::memory_order_release);
+                barrier_detail::spinUntil([&] { return me.release.load(std::memory_order_acquire) == sense; });
+                break;
+            }
+            if (thread + bit < numThreads) {
+                barrier_detail::spinUntil([&] {
+                    return me.arrived[round].load(std::memory_order_acquire) == sense;
+                });
+            }
+        }
+
+        //будим тех, у кого выиграли, начиная с последнего раунда
+        for (int r = round - 1; r >= 0; --r) {
+            int loser = thread + (1 << r);
+            if (loser < numThreads) {
+                nodes[loser].release.store(sense, std::memory_order_release);
+            }
+        }
+    }
+};
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "../benchmark/include/benchmark/benchmark.h"
+#include "locks.h"
+#include "rw_locks.h"
+#include "../thread_harness.h"
+#include "../latency_histogram.h"
+#include "../ring_buffer.h"
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <atomic>
 #include <condition_variable>
 #include <semaphore>
 #include <barrier>
+#include <array>
 #include <vector>
 #include <chrono>
 #include <random>
@@ -19,191 +26,756 @@ private:
         return static_cast<char>(distribution(generator));
     }
     
-    static void simulatedWork() {
-        volatile char c = generateRandomChar();
-        (void)c;
-        std::this_thread::sleep_for(std::chrono::microseconds(10));
+public:
+    //работа внутри критической секции, задаётся аргументами work и amount
+    enum WorkKind : int64_t {
+        WORK_SLEEP = 0,     //исходный вариант: sleep_for(amount нс), меряет в основном планировщик
+        WORK_NONE = 1,      //пустая секция: чистая стоимость захвата и освобождения
+        WORK_SPIN = 2,      //калиброванное вращение на amount нс
+        WORK_MEMORY = 3     //проход по общему буферу из amount байт, по записи на кэш-линию
+    };
+    
+    //работа в критической секции и запись задержек захвата. Тела бенчмарков
+    //берут waitStart() прямо перед lock()/acquire() и отмечают acquired() сразу
+    //после, как в primitives.cpp: в задержку не попадают ни освобождение, ни
+    //цикл, ни пробуждение потоков на старте прогона
+    class SimulatedWork {
+    private:
+        WorkKind kind;
+        int64_t amount;
+        uint64_t spinIterations = 0;
+        LatencyRecorder latency;
+        //атомики с relaxed-доступом компилируются в обычные mov, но не дают
+        //гонки данных там, где работа выполняется вне блокировки (барьер)
+        std::vector<std::atomic<uint64_t>> buffer;
+        
+        //итераций пустого цикла в наносекунду, измеряется один раз на процесс
+        static double spinIterationsPerNs() {
+            static const double rate = []() {
+                constexpr uint64_t CALIBRATION_ITERATIONS = 1 << 24;
+                auto start = std::chrono::steady_clock::now();
+                spin(CALIBRATION_ITERATIONS);
+                auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+                return CALIBRATION_ITERATIONS / elapsed.count();
+            }();
+            return rate;
+        }
+        
+        static void spin(uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                asm volatile("" ::: "memory");
+            }
+        }
+        
+    public:
+        explicit SimulatedWork(const benchmark::State& state)
+            : kind(static_cast<WorkKind>(state.range(2))), amount(state.range(3)),
+              latency(static_cast<int>(state.range(0))),
+              buffer(kind == WORK_MEMORY ? (amount + 7) / 8 : 0) {
+            if (kind == WORK_SPIN) {
+                spinIterations = static_cast<uint64_t>(amount * spinIterationsPerNs());
+            }
+        }
+        
+        void startRun(bool recordLatency) {
+            latency.setEnabled(recordLatency);
+            latency.startRun();
+        }
+        
+        LatencyReport latencyReport() const { return latency.report(); }
+        
+        LatencyRecorder::Clock::time_point waitStart() const { return latency.waitStart(); }
+        void acquired(int thread, LatencyRecorder::Clock::time_point start) { latency.acquired(thread, start); }
+        void finished() { latency.finished(); }
+        
+        void operator()(int) { run(); }
+        
+        void run() {
+            switch (kind) {
+                case WORK_SLEEP: {
+                    volatile char c = generateRandomChar();
+                    (void)c;
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(amount));
+                    break;
+                }
+                case WORK_NONE:
+                    break;
+                case WORK_SPIN:
+                    spin(spinIterations);
+                    break;
+                case WORK_MEMORY:
+                    for (size_t i = 0; i < buffer.size(); i += CACHE_LINE / sizeof(uint64_t)) {
+                        buffer[i].store(buffer[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    }
+                    break;
+            }
+        }
+    };
+    
+    //операций в секунду и время на операцию по времени конкурентного участка
+    static void reportThroughput(benchmark::State& state, int64_t operations) {
+        state.counters["ops/s"] = benchmark::Counter(static_cast<double>(operations),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["time/op"] = benchmark::Counter(static_cast<double>(operations),
+                                                       benchmark::Counter::kIsIterationInvariantRate
+                                                       | benchmark::Counter::kInvert);
+    }
+    
+    //прогон без записи задержек; возвращает время конкурентного участка в секундах
+    template <typename Body>
+    static double timedRun(ThreadHarness& harness, SimulatedWork& work, const Body& body) {
+        work.startRun(false);
+        return std::chrono::duration<double>(harness.run(body)).count();
+    }
+    
+    //отдельный прогон с записью задержек вне замера: чтение часов в каждой
+    //операции исказило бы время. Задержки в наносекундах, честность - индекс Джайна
+    //по доле выполненных операций; без счётчика, если захватов на поток слишком мало
+    template <typename Body>
+    static void reportLatency(benchmark::State& state, ThreadHarness& harness, SimulatedWork& work, const Body& body) {
+        work.startRun(true);
+        harness.run([&work, &body](int thread_id) {
+            body(thread_id);
+            work.finished();
+        });
+        LatencyReport report = work.latencyReport();
+        state.counters["p50_ns"] = static_cast<double>(report.p50);
+        state.counters["p99_ns"] = static_cast<double>(report.p99);
+        state.counters["p999_ns"] = static_cast<double>(report.p999);
+        state.counters["max_ns"] = static_cast<double>(report.max);
+        if (report.fairness) {
+            state.counters["fairness"] = *report.fairness;
+        }
+    }
+    
+    //сетка аргументов: {потоки, итерации, вид работы, объём работы}.
+    //Время итерации задаёт ThreadHarness, поэтому замер ручной
+    static void workGrid(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgNames({"threads", "iterations", "work", "amount"});
+        benchmark->UseManualTime();
+        const std::vector<std::pair<WorkKind, int64_t>> works = {
+            {WORK_SLEEP, 10000}, {WORK_NONE, 0}, {WORK_SPIN, 100}, {WORK_SPIN, 1000},
+            {WORK_MEMORY, 4096}, {WORK_MEMORY, 256 * 1024}};
+        for (const auto& [kind, amount] : works) {
+            for (int64_t threads : {4, 8, 16}) {
+                benchmark->Args({threads, 50, kind, amount});
+            }
+        }
     }
     
-public:
     static void BM_Mutex(benchmark::State& state) {
         std::mutex mtx;
-        std::vector<std::thread> threads;
         int num_threads = state.range(0);
         int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
         
-        for (auto _ : state) {
-            threads.clear();
-            
-            for (int i = 0; i < num_threads; ++i) {
-                threads.emplace_back([&mtx, iterations]() {
-                    for (int j = 0; j < iterations; ++j) {
-                        std::lock_guard<std::mutex> lock(mtx);
-                        simulatedWork();
-                    }
-                });
-            }
-            
-            for (auto& t : threads) {
-                t.join();
+        auto body = [&simulatedWork, &mtx, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                std::lock_guard<std::mutex> lock(mtx);
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
             }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
         }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
     }
     
     static void BM_Semaphore(benchmark::State& state) {
         std::counting_semaphore<1000> sem(1);
-        std::vector<std::thread> threads;
         int num_threads = state.range(0);
         int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
         
-        for (auto _ : state) {
-            threads.clear();
-            
-            for (int i = 0; i < num_threads; ++i) {
-                threads.emplace_back([&sem, iterations]() {
-                    for (int j = 0; j < iterations; ++j) {
-                        sem.acquire();
-                        simulatedWork();
-                        sem.release();
-                    }
-                });
-            }
-            
-            for (auto& t : threads) {
-                t.join();
+        auto body = [&simulatedWork, &sem, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                sem.acquire();
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+                sem.release();
             }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
         }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
     }
     
     static void BM_Barrier(benchmark::State& state) {
-        std::vector<std::thread> threads;
         int num_threads = state.range(0);
         int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        std::barrier sync_point(num_threads);
+        ThreadHarness harness(num_threads);
         
-        for (auto _ : state) {
-            threads.clear();
-            std::barrier sync_point(num_threads);
-            
-            for (int i = 0; i < num_threads; ++i) {
-                threads.emplace_back([&sync_point, iterations]() {
-                    for (int j = 0; j < iterations; ++j) {
-                        simulatedWork();
-                        sync_point.arrive_and_wait();
-                    }
-                });
-            }
-            
-            for (auto& t : threads) {
-                t.join();
+        auto body = [&simulatedWork, &sync_point, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                simulatedWork(thread_id);
+                auto wait_start = simulatedWork.waitStart();
+                sync_point.arrive_and_wait();
+                simulatedWork.acquired(thread_id, wait_start);
             }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
         }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
     }
     
     static void BM_SpinLock(benchmark::State& state) {
         std::atomic_flag lock = ATOMIC_FLAG_INIT;
-        std::vector<std::thread> threads;
         int num_threads = state.range(0);
         int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
         
-        for (auto _ : state) {
-            threads.clear();
-            
-            for (int i = 0; i < num_threads; ++i) {
-                threads.emplace_back([&lock, iterations]() {
-                    for (int j = 0; j < iterations; ++j) {
-                        while (lock.test_and_set(std::memory_order_acquire)) {}
-                        simulatedWork();
-                        lock.clear(std::memory_order_release);
-                    }
-                });
-            }
-            
-            for (auto& t : threads) {
-                t.join();
+        auto body = [&simulatedWork, &lock, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                while (lock.test_and_set(std::memory_order_acquire)) {}
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+                lock.clear(std::memory_order_release);
             }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
         }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
     }
     
     static void BM_SpinWait(benchmark::State& state) {
         std::atomic<bool> lock(false);
-        std::vector<std::thread> threads;
         int num_threads = state.range(0);
         int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
         
-        for (auto _ : state) {
-            threads.clear();
-            
-            for (int i = 0; i < num_threads; ++i) {
-                threads.emplace_back([&lock, iterations]() {
-                    for (int j = 0; j < iterations; ++j) {
-                        bool expected = false;
-                        while (!lock.compare_exchange_weak(expected, true, 
-                                std::memory_order_acquire, std::memory_order_relaxed)) {
-                            expected = false;
-                            if (j % 10 == 0) {
-                                std::this_thread::yield();
-                            }
-                        }
-                        simulatedWork();
-                        lock.store(false, std::memory_order_release);
+        auto body = [&simulatedWork, &lock, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                bool expected = false;
+                int spins = 0;
+                while (!lock.compare_exchange_weak(expected, true, 
+                        std::memory_order_acquire, std::memory_order_relaxed)) {
+                    expected = false;
+                    if (++spins % 10 == 0) {
+                        std::this_thread::yield();
                     }
-                });
-            }
-            
-            for (auto& t : threads) {
-                t.join();
+                }
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+                lock.store(false, std::memory_order_release);
             }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
         }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
     }
     
     static void BM_Monitor(benchmark::State& state) {
         std::mutex mtx;
         std::condition_variable cv;
         bool available = true;
-        std::vector<std::thread> threads;
         int num_threads = state.range(0);
         int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &mtx, &cv, &available, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&available]() { return available; });
+                simulatedWork.acquired(thread_id, wait_start);
+                available = false;
+                
+                simulatedWork(thread_id);
+                
+                available = true;
+                lock.unlock();
+                cv.notify_one();
+            }
+        };
         
         for (auto _ : state) {
-            threads.clear();
-            
-            for (int i = 0; i < num_threads; ++i) {
-                threads.emplace_back([&mtx, &cv, &available, iterations]() {
-                    for (int j = 0; j < iterations; ++j) {
-                        std::unique_lock<std::mutex> lock(mtx);
-                        cv.wait(lock, [&available]() { return available; });
-                        available = false;
-                        
-                        simulatedWork();
-                        
-                        available = true;
-                        lock.unlock();
-                        cv.notify_one();
-                    }
-                });
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+        }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    static void BM_TicketLock(benchmark::State& state) {
+        TicketLock lock;
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &lock, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                std::lock_guard<TicketLock> guard(lock);
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+        }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    static void BM_McsLock(benchmark::State& state) {
+        McsLock lock;
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &lock, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                McsLock::Guard guard(lock);
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+        }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    static void BM_ClhLock(benchmark::State& state) {
+        ClhLock lock;
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &lock, iterations](int thread_id) {
+            ClhLock::Handle handle;
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                lock.lock(handle);
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+                lock.unlock(handle);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+        }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    static void BM_FutexMutex(benchmark::State& state) {
+        FutexMutex mtx;
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &mtx, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                std::lock_guard<FutexMutex> lock(mtx);
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+        }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    template <typename BackoffPolicy>
+    static void BM_SpinLockBackoff(benchmark::State& state) {
+        SpinLock<BackoffPolicy> lock;
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        SimulatedWork simulatedWork(state);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &lock, iterations](int thread_id) {
+            for (int j = 0; j < iterations; ++j) {
+                auto wait_start = simulatedWork.waitStart();
+                std::lock_guard<SpinLock<BackoffPolicy>> guard(lock);
+                simulatedWork.acquired(thread_id, wait_start);
+                simulatedWork(thread_id);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+        }
+        reportThroughput(state, num_threads * iterations);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    //очереди: работа выполняется при производстве и при обработке элемента,
+    //операция - доставленный элемент. Элемент - его номер, после каждого
+    //замера проверяется, что все номера получены ровно один раз
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+    
+    //«захват» для очереди - успешная запись или чтение, ожидание - попытки до неё
+    template <typename Queue>
+    static void pushWaiting(Queue& queue, uint64_t item, SimulatedWork& work, int thread_id) {
+        auto wait_start = work.waitStart();
+        SpinWaiter waiter;
+        while (!queue.tryPush(item)) {
+            waiter.wait();
+        }
+        work.acquired(thread_id, wait_start);
+    }
+    
+    template <typename Queue>
+    static uint64_t popWaiting(Queue& queue, SimulatedWork& work, int thread_id) {
+        auto wait_start = work.waitStart();
+        SpinWaiter waiter;
+        uint64_t item;
+        while (!queue.tryPop(item)) {
+            waiter.wait();
+        }
+        work.acquired(thread_id, wait_start);
+        return item;
+    }
+    
+    //поток 0 только разбирает очередь, остальные производят по iterations элементов;
+    //у потребителя нет своей работы, записываются только его ожидания чтения
+    static void BM_MpscQueue(benchmark::State& state) {
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        int items = (num_threads - 1) * iterations;
+        SimulatedWork simulatedWork(state);
+        MpscRingBuffer<uint64_t> queue(QUEUE_CAPACITY);
+        DeliveryCheck check(items);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &queue, &check, iterations, items](int thread_id) {
+            if (thread_id == 0) {
+                for (int j = 0; j < items; ++j) {
+                    check.mark(popWaiting(queue, simulatedWork, thread_id));
+                }
+                return;
+            }
+            uint64_t first = static_cast<uint64_t>(thread_id - 1) * iterations;
+            for (int j = 0; j < iterations; ++j) {
+                simulatedWork(thread_id);
+                pushWaiting(queue, first + j, simulatedWork, thread_id);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+            if (check.errors() != 0) {
+                state.SkipWithError("MPSC: элементы потеряны или доставлены повторно");
+                break;
+            }
+            check.reset();
+        }
+        reportThroughput(state, items);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    //чётные потоки производят, нечётные потребляют, по iterations элементов на поток
+    static void BM_MpmcQueue(benchmark::State& state) {
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        int items = num_threads / 2 * iterations;
+        SimulatedWork simulatedWork(state);
+        MpmcRingBuffer<uint64_t> queue(QUEUE_CAPACITY);
+        DeliveryCheck check(items);
+        ThreadHarness harness(num_threads);
+        
+        auto body = [&simulatedWork, &queue, &check, iterations](int thread_id) {
+            if (thread_id % 2 == 1) {
+                for (int j = 0; j < iterations; ++j) {
+                    check.mark(popWaiting(queue, simulatedWork, thread_id));
+                    simulatedWork(thread_id);
+                }
+                return;
+            }
+            uint64_t first = static_cast<uint64_t>(thread_id / 2) * iterations;
+            for (int j = 0; j < iterations; ++j) {
+                simulatedWork(thread_id);
+                pushWaiting(queue, first + j, simulatedWork, thread_id);
+            }
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(timedRun(harness, simulatedWork, body));
+            if (check.errors() != 0) {
+                state.SkipWithError("MPMC: элементы потеряны или доставлены повторно");
+                break;
+            }
+            check.reset();
+        }
+        reportThroughput(state, items);
+        reportLatency(state, harness, simulatedWork, body);
+    }
+    
+    //чтение и запись общей таблицы: читатель суммирует TABLE_SIZE значений
+    //(8 кэш-линий), писатель увеличивает каждое на 1. Все значения всегда
+    //равны, поэтому читатель видит, если прочитал таблицу посреди записи.
+    //У таблиц один интерфейс: конструктор от числа потоков, read(thread) -
+    //true, если прочитано согласованное состояние, и write(thread)
+    static constexpr int TABLE_SIZE = 64;
+    using AtomicTable = std::array<std::atomic<uint64_t>, TABLE_SIZE>;
+    
+    static uint64_t loadValue(const std::atomic<uint64_t>& value) { return value.load(std::memory_order_relaxed); }
+    static uint64_t loadValue(uint64_t value) { return value; }
+    
+    template <typename Values>
+    static bool scanTable(const Values& values) {
+        uint64_t first = loadValue(values[0]);
+        uint64_t sum = 0;
+        for (const auto& value : values) {
+            sum += loadValue(value);
+        }
+        return sum == first * TABLE_SIZE;
+    }
+    
+    static void bumpTable(AtomicTable& values) {
+        for (auto& value : values) {
+            value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+    
+    struct MutexTable {
+        std::mutex mtx;
+        alignas(CACHE_LINE) AtomicTable values{};
+        
+        explicit MutexTable(int) {}
+        bool read(int) {
+            std::lock_guard<std::mutex> lock(mtx);
+            return scanTable(values);
+        }
+        void write(int) {
+            std::lock_guard<std::mutex> lock(mtx);
+            bumpTable(values);
+        }
+    };
+    
+    struct SharedMutexTable {
+        std::shared_mutex mtx;
+        alignas(CACHE_LINE) AtomicTable values{};
+        
+        explicit SharedMutexTable(int) {}
+        bool read(int) {
+            std::shared_lock<std::shared_mutex> lock(mtx);
+            return scanTable(values);
+        }
+        void write(int) {
+            std::lock_guard<std::shared_mutex> lock(mtx);
+            bumpTable(values);
+        }
+    };
+    
+    //порванное чтение здесь допустимо: оно повторяется, пока счётчик не совпадёт
+    struct SeqLockTable {
+        SeqLock seqlock;
+        alignas(CACHE_LINE) AtomicTable values{};
+        
+        explicit SeqLockTable(int) {}
+        bool read(int) {
+            bool consistent;
+            uint64_t start;
+            do {
+                start = seqlock.readBegin();
+                consistent = scanTable(values);
+            } while (seqlock.readRetry(start));
+            return consistent;
+        }
+        void write(int) {
+            std::lock_guard<SeqLock> lock(seqlock);
+            bumpTable(values);
+        }
+    };
+    
+    struct DistributedRwTable {
+        DistributedRwLock rwlock;
+        alignas(CACHE_LINE) AtomicTable values{};
+        
+        explicit DistributedRwTable(int threads) : rwlock(threads) {}
+        bool read(int thread) {
+            rwlock.lockShared(thread);
+            bool consistent = scanTable(values);
+            rwlock.unlockShared(thread);
+            return consistent;
+        }
+        void write(int) {
+            std::lock_guard<DistributedRwLock> lock(rwlock);
+            bumpTable(values);
+        }
+    };
+    
+    //RCU: читатель берёт текущую неизменяемую версию под защитой эпохи,
+    //писатель копирует версию, меняет копию, публикует её и удаляет старую,
+    //когда все читатели старой эпохи вышли. Писатели сериализованы мьютексом
+    struct RcuTable {
+        using Version = std::array<uint64_t, TABLE_SIZE>;
+        
+        EpochDomain epochs;
+        std::mutex writers;
+        alignas(CACHE_LINE) std::atomic<Version*> current{new Version{}};
+        
+        explicit RcuTable(int threads) : epochs(threads) {}
+        ~RcuTable() { delete current.load(); }
+        
+        bool read(int thread) {
+            epochs.enter(thread);
+            bool consistent = scanTable(*current.load(std::memory_order_seq_cst));
+            epochs.exit(thread);
+            return consistent;
+        }
+        void write(int) {
+            std::lock_guard<std::mutex> lock(writers);
+            Version* next = new Version(*current.load(std::memory_order_relaxed));
+            for (auto& value : *next) {
+                ++value;
+            }
+            Version* previous = current.exchange(next, std::memory_order_seq_cst);
+            epochs.synchronize();
+            delete previous;
+        }
+    };
+    
+    //сетка для таблиц: доля чтений в процентах
+    static void readRatioGrid(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgNames({"threads", "iterations", "reads"});
+        benchmark->UseManualTime();
+        for (int64_t reads : {50, 90, 95, 99, 100}) {
+            for (int64_t threads : {4, 8, 16}) {
+                benchmark->Args({threads, 1000, reads});
             }
-            
-            for (auto& t : threads) {
-                t.join();
+        }
+    }
+    
+    template <typename Table>
+    static void BM_ReadMostly(benchmark::State& state) {
+        int num_threads = state.range(0);
+        int iterations = state.range(1);
+        int read_percent = state.range(2);
+        Table table(num_threads);
+        std::atomic<int> torn_reads{0};
+        ThreadHarness harness(num_threads);
+        
+        //61 взаимно просто со 100: в каждой сотне операций потока ровно
+        //read_percent чтений, и записи перемешаны с ними, а не идут подряд
+        auto body = [&table, &torn_reads, iterations, read_percent](int thread_id) {
+            int torn = 0;
+            for (int j = 0; j < iterations; ++j) {
+                if ((j * 61 + thread_id * 17) % 100 < read_percent) {
+                    torn += !table.read(thread_id);
+                } else {
+                    table.write(thread_id);
+                }
             }
+            torn_reads.fetch_add(torn, std::memory_order_relaxed);
+        };
+        
+        for (auto _ : state) {
+            state.SetIterationTime(std::chrono::duration<double>(harness.run(body)).count());
         }
+        if (torn_reads.load() != 0) {
+            state.SkipWithError("читатель видел таблицу посреди записи");
+        }
+        reportThroughput(state, static_cast<int64_t>(num_threads) * iterations);
     }
 };
 
 BENCHMARK(CompleteSyncBenchmark::BM_Mutex)
-    ->Args({4, 50})->Args({8, 50})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(CompleteSyncBenchmark::BM_Semaphore)
-    ->Args({4, 50})->Args({8, 50})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(CompleteSyncBenchmark::BM_Barrier)
-    ->Args({4, 50})->Args({8, 50})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(CompleteSyncBenchmark::BM_SpinLock)
-    ->Args({4, 50})->Args({8, 50})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(CompleteSyncBenchmark::BM_SpinWait)
-    ->Args({4, 50})->Args({8, 50})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(CompleteSyncBenchmark::BM_Monitor)
-    ->Args({4, 50})->Args({8, 50})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_TicketLock)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_McsLock)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_ClhLock)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_FutexMutex)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_SpinLockBackoff<NoBackoff>)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_SpinLockBackoff<PauseBackoff>)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_SpinLockBackoff<ExponentialBackoff>)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_SpinLockBackoff<TtasBackoff>)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_SpinLockBackoff<YieldAfterBackoff<64>>)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_SpinLockBackoff<TtasYieldAfterBackoff<64>>)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_MpscQueue)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_MpmcQueue)
+    ->Apply(CompleteSyncBenchmark::workGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_ReadMostly<CompleteSyncBenchmark::MutexTable>)
+    ->Apply(CompleteSyncBenchmark::readRatioGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_ReadMostly<CompleteSyncBenchmark::SharedMutexTable>)
+    ->Apply(CompleteSyncBenchmark::readRatioGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_ReadMostly<CompleteSyncBenchmark::SeqLockTable>)
+    ->Apply(CompleteSyncBenchmark::readRatioGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_ReadMostly<CompleteSyncBenchmark::DistributedRwTable>)
+    ->Apply(CompleteSyncBenchmark::readRatioGrid)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(CompleteSyncBenchmark::BM_ReadMostly<CompleteSyncBenchmark::RcuTable>)
+    ->Apply(CompleteSyncBenchmark::readRatioGrid)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+constexpr size_t CACHE_LINE = 64;
+
+//подсказка процессору, что поток крутится в цикле ожидания
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+//политики ожидания для SpinLock: wait() вызывается после каждой неудачной
+//попытки, READ_BEFORE_CAS включает чтение флага перед exchange (TTAS)
+
+//пустое тело цикла, как в исходном BM_SpinLock
+struct NoBackoff {
+    static constexpr bool READ_BEFORE_CAS = false;
+    void wait() {}
+};
+
+struct PauseBackoff {
+    static constexpr bool READ_BEFORE_CAS = false;
+    void wait() { cpuRelax(); }
+};
+
+//число pause удваивается после каждой неудачи, но не больше MAX_PAUSES
+struct ExponentialBackoff {
+    static constexpr bool READ_BEFORE_CAS = false;
+    static constexpr uint32_t MAX_PAUSES = 1024;
+    uint32_t pauses = 1;
+
+    void wait() {
+        for (uint32_t i = 0; i < pauses; ++i) {
+            cpuRelax();
+        }
+        pauses = std::min(pauses * 2, MAX_PAUSES);
+    }
+};
+
+//test-and-test-and-set: пока флаг занят, поток только читает свою копию
+//кэш-линии и не захватывает её на запись
+struct TtasBackoff {
+    static constexpr bool READ_BEFORE_CAS = true;
+    void wait() { cpuRelax(); }
+};
+
+//pause первые N попыток, дальше yield. Без уступки потоки, которых больше,
+//чем ядер, ждут вытесненного владельца целый квант планировщика
+template <uint32_t N>
+struct YieldAfterBackoff {
+    static constexpr bool READ_BEFORE_CAS = false;
+    uint32_t spins = 0;
+
+    void wait() {
+        if (spins < N) {
+            ++spins;
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+//то же с чтением флага перед exchange: TTAS и уступка вместе
+template <uint32_t N>
+struct TtasYieldAfterBackoff : YieldAfterBackoff<N> {
+    static constexpr bool READ_BEFORE_CAS = true;
+};
+
+//ожидание в очередях FIFO-блокировок ниже
+using SpinWaiter = YieldAfterBackoff<1024>;
+
+template <typename BackoffPolicy>
+class SpinLock {
+private:
+    alignas(CACHE_LINE) std::atomic<bool> locked{false};
+
+public:
+    void lock() {
+        BackoffPolicy backoff;
+        while (true) {
+            if constexpr (BackoffPolicy::READ_BEFORE_CAS) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    backoff.wait();
+                }
+            }
+            if (!locked.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+            backoff.wait();
+        }
+    }
+
+    bool try_lock() {
+        return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() { locked.store(false, std::memory_order_release); }
+};
+
+//билетная блокировка: потоки входят строго в порядке взятых билетов.
+//Счётчики в разных кэш-линиях, чтобы взятие билета не сбивало линию владельца
+class TicketLock {
+private:
+    alignas(CACHE_LINE) std::atomic<uint32_t> nextTicket{0};
+    alignas(CACHE_LINE) std::atomic<uint32_t> nowServing{0};
+
+public:
+    void lock() {
+        uint32_t ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+        SpinWaiter waiter;
+        while (true) {
+            uint32_t serving = nowServing.load(std::memory_order_acquire);
+            if (serving == ticket) {
+                return;
+            }
+            //пропорциональная пауза: чем дальше очередь, тем реже опрос
+            for (uint32_t i = 0; i < ticket - serving; ++i) {
+                waiter.wait();
+            }
+        }
+    }
+
+    void unlock() {
+        nowServing.store(nowServing.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+//очередь MCS: каждый поток крутится на флаге своего узла,
+//поэтому при передаче блокировки сбивается одна кэш-линия
+class McsLock {
+public:
+    struct alignas(CACHE_LINE) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{false};
+    };
+
+private:
+    alignas(CACHE_LINE) std::atomic<Node*> tail{nullptr};
+
+public:
+    void lock(Node& node) {
+        node.next.store(nullptr, std::memory_order_relaxed);
+        node.locked.store(true, std::memory_order_relaxed);
+        Node* previous = tail.exchange(&node, std::memory_order_acq_rel);
+        if (previous == nullptr) {
+            return;
+        }
+        previous->next.store(&node, std::memory_order_release);
+        SpinWaiter waiter;
+        while (node.locked.load(std::memory_order_acquire)) {
+            waiter.wait();
+        }
+    }
+
+    void unlock(Node& node) {
+        Node* successor = node.next.load(std::memory_order_acquire);
+        if (successor == nullptr) {
+            Node* expected = &node;
+            if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+                return;
+            }
+            //преемник уже встал в хвост, но ещё не связал себя с узлом
+            SpinWaiter waiter;
+            while ((successor = node.next.load(std::memory_order_acquire)) == nullptr) {
+                waiter.wait();
+            }
+        }
+        successor->locked.store(false, std::memory_order_release);
+    }
+
+    //захват на время области видимости, узел живёт на стеке
+    class Guard {
+    private:
+        McsLock& owner;
+        Node node;
+
+    public:
+        explicit Guard(McsLock& lock) : owner(lock) { owner.lock(node); }
+        ~Guard() { owner.unlock(node); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+};
+
+//очередь CLH: поток крутится на узле предшественника и после освобождения
+//забирает его узел себе, поэтому узлы переходят от потока к потоку
+class ClhLock {
+public:
+    struct alignas(CACHE_LINE) Node {
+        std::atomic<bool> locked{false};
+    };
+
+    //узлы потока; создаётся по одному на поток и живёт дольше его захватов
+    class Handle {
+    private:
+        friend class ClhLock;
+        Node* node = new Node;
+        Node* predecessor = nullptr;
+
+    public:
+        Handle() = default;
+        ~Handle() { delete node; }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+    };
+
+private:
+    alignas(CACHE_LINE) std::atomic<Node*> tail{new Node};
+
+public:
+    ~ClhLock() { delete tail.load(); }
+
+    void lock(Handle& handle) {
+        handle.node->locked.store(true, std::memory_order_relaxed);
+        handle.predecessor = tail.exchange(handle.node, std::memory_order_acq_rel);
+        SpinWaiter waiter;
+        while (handle.predecessor->locked.load(std::memory_order_acquire)) {
+            waiter.wait();
+        }
+    }
+
+    void unlock(Handle& handle) {
+        handle.node->locked.store(false, std::memory_order_release);
+        handle.node = handle.predecessor;
+    }
+};
+
+//мьютекс на futex (по Дреппере): 0 - свободен, 1 - занят, 2 - занят и есть спящие.
+//Сначала короткое вращение, затем поток засыпает в ядре; unlock будит
+//только если кто-то мог уснуть
+class FutexMutex {
+private:
+    static constexpr int SPIN_LIMIT = 100;
+
+    alignas(CACHE_LINE) std::atomic<int> state{0};
+
+    void futexWait(int expected) {
+        syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    void futexWake() {
+        syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+public:
+    void lock() {
+        int expected = 0;
+        for (int spin = 0; spin < SPIN_LIMIT; ++spin) {
+            if (state.load(std::memory_order_relaxed) == 0
+                && state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            expected = 0;
+            cpuRelax();
+        }
+
+        //освободившийся мьютекс берётся сразу в состоянии 2: о спящих мы не знаем
+        int previous = state.exchange(2, std::memory_order_acquire);
+        while (previous != 0) {
+            futexWait(2);
+            previous = state.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    void unlock() {
+        if (state.exchange(0, std::memory_order_release) == 2) {
+            futexWake();
+        }
+    }
+};
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int), "FutexMutex: futex требует 32-битного слова");
@@ -2,9 +2,14 @@
 #include <iostream>
 
 int main(int argc, char** argv) {
-    std::cout << "   GOOGLE BENCHMARK - ALL 6 SYNCHRONIZATION PRIMITIVES" << std::endl;
-    std::cout << "Testing: Mutex, Semaphore, Barrier, SpinLock, SpinWait, Monitor" << std::endl;
+    std::cout << "   GOOGLE BENCHMARK - ALL 12 SYNCHRONIZATION PRIMITIVES" << std::endl;
+    std::cout << "Testing: Mutex, Semaphore, Barrier, SpinLock, SpinWait, Monitor," << std::endl;
+    std::cout << "         TicketLock, McsLock, ClhLock, FutexMutex" << std::endl;
+    std::cout << "Lock-free queues: MpscQueue, MpmcQueue" << std::endl;
+    std::cout << "Read-mostly: Mutex, SharedMutex, SeqLock, DistributedRw, Rcu (reads 50-100%)" << std::endl;
+    std::cout << "SpinLock backoff: None, Pause, Exponential, TTAS, YieldAfter<64>, TtasYieldAfter<64>" << std::endl;
     std::cout << "Threads: 4, 8, 16 | Iterations: 50" << std::endl;
+    std::cout << "Work: sleep 10us, none, spin 100/1000ns, memory 4KB/256KB" << std::endl;
     
     ::benchmark::Initialize(&argc, argv);
     
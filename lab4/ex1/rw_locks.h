@@ -0,0 +1,138 @@
+#pragma once
+
+#include "locks.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//примитивы для данных, которые в основном читают. Читатели с номером слота
+//пишут только в свою кэш-линию
+
+//seqlock: читатель не пишет в общую память вовсе, а перечитывает данные,
+//если за время чтения счётчик изменился. Нечётный счётчик - идёт запись.
+//Данные под seqlock должны читаться атомиками (relaxed), иначе гонка - UB
+class SeqLock {
+private:
+    alignas(CACHE_LINE) std::atomic<uint64_t> sequence{0};
+    SpinLock<TtasYieldAfterBackoff<1024>> writers;
+
+public:
+    uint64_t readBegin() const {
+        SpinWaiter waiter;
+        uint64_t start;
+        while ((start = sequence.load(std::memory_order_acquire)) & 1) {
+            waiter.wait();
+        }
+        return start;
+    }
+
+    //true, если прочитанное могло быть порвано записью и чтение нужно повторить
+    bool readRetry(uint64_t start) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) != start;
+    }
+
+    void lock() {
+        writers.lock();
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void unlock() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        writers.unlock();
+    }
+};
+
+//распределённая RW-блокировка (big-reader lock): у каждого слота свой счётчик
+//читателей в отдельной кэш-линии, так что читатели разных слотов не делят линий.
+//Писатель поднимает общий флаг и ждёт, пока опустеют все слоты
+class DistributedRwLock {
+private:
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<int> readers{0};
+    };
+
+    std::vector<Slot> slots;
+    alignas(CACHE_LINE) std::atomic<bool> writing{false};
+
+public:
+    explicit DistributedRwLock(int slotCount) : slots(slotCount) {}
+
+    //слоты могут делить несколько читателей: это только счётчик.
+    //Флаг и счётчик проверяются крест-накрест, как в алгоритме Деккера: запись
+    //и последующее чтение с обеих сторон seq_cst, иначе чтение по стандарту
+    //может обогнать запись (на x86 это скрывают xchg и lock xadd)
+    void lockShared(int slot) {
+        Slot& mine = slots[slot % slots.size()];
+        while (true) {
+            mine.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writing.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            mine.readers.fetch_sub(1, std::memory_order_release);
+            SpinWaiter waiter;
+            while (writing.load(std::memory_order_relaxed)) {
+                waiter.wait();
+            }
+        }
+    }
+
+    void unlockShared(int slot) { slots[slot % slots.size()].readers.fetch_sub(1, std::memory_order_release); }
+
+    void lock() {
+        SpinWaiter waiter;
+        while (writing.exchange(true, std::memory_order_seq_cst)) {
+            waiter.wait();
+        }
+        for (auto& slot : slots) {
+            while (slot.readers.load(std::memory_order_seq_cst) != 0) {
+                waiter.wait();
+            }
+        }
+    }
+
+    void unlock() { writing.store(false, std::memory_order_release); }
+};
+
+//эпохи для RCU-чтения: читатель объявляет в своём слоте текущую эпоху на время
+//чтения. Писатель подменяет указатель на новую версию, затем synchronize()
+//продвигает эпоху и ждёт читателей, вошедших раньше: после этого старую
+//версию никто не держит и её можно удалить. Слот у каждого читающего потока свой
+class EpochDomain {
+private:
+    static constexpr uint64_t IDLE = std::numeric_limits<uint64_t>::max();
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<uint64_t> epoch{IDLE};
+    };
+
+    std::vector<Slot> slots;
+    alignas(CACHE_LINE) std::atomic<uint64_t> globalEpoch{1};
+
+public:
+    explicit EpochDomain(int slotCount) : slots(slotCount) {}
+
+    //seq_cst: объявление эпохи должно быть видно до чтения указателя на данные,
+    //сам указатель тоже читается с seq_cst. Эпоха читается тоже с seq_cst, а не
+    //relaxed: увидев новую эпоху, читатель синхронизируется с её fetch_add и
+    //видит указатель, опубликованный до него, а не старую версию
+    void enter(int slot) {
+        slots[slot].epoch.store(globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+
+    void exit(int slot) { slots[slot].epoch.store(IDLE, std::memory_order_release); }
+
+    //чтение слотов seq_cst: с acquire оно могло бы выполниться раньше fetch_add
+    //и пропустить читателя, который ещё видит старую версию
+    void synchronize() {
+        uint64_t target = globalEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        SpinWaiter waiter;
+        for (auto& slot : slots) {
+            while (slot.epoch.load(std::memory_order_seq_cst) < target) {
+                waiter.wait();
+            }
+        }
+    }
+};
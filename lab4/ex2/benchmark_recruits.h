@@ -0,0 +1,306 @@
+#pragma once
+
+#include "../benchmark/include/benchmark/benchmark.h"
+#include "recruit_selection.h"
+#include "recruit_generator.h"
+#include "recruit_incremental.h"
+#include "recruit_stats.h"
+#include <cstdint>
+#include <string>
+#include <sys/stat.h>
+
+//наборы данных генерируются один раз на размер и лежат рядом с бинарником
+//как recruits_<строк>.txt; в памяти держится только последний загруженный
+class RecruitBenchmark {
+private:
+    static size_t fileBytes(const std::string& filename) {
+        struct stat info;
+        return ::stat(filename.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    }
+
+    static std::string dataset(size_t rows) {
+        std::string filename = "recruits_" + std::to_string(rows) + ".txt";
+        if (fileBytes(filename) == 0) {
+            generateTestData(filename, rows);
+        }
+        return filename;
+    }
+
+    static const std::vector<Recruit>& recruits(size_t rows) {
+        static size_t cached_rows = 0;
+        static std::vector<Recruit> cached;
+        if (cached_rows != rows) {
+            cached = readRecruitsFromFileMapped(dataset(rows));
+            cached_rows = rows;
+        }
+        return cached;
+    }
+
+    static const RecruitTable& table(size_t rows) {
+        static size_t cached_rows = 0;
+        static RecruitTable cached;
+        if (cached_rows != rows) {
+            cached = loadRecruitTable(dataset(rows));
+            cached_rows = rows;
+        }
+        return cached;
+    }
+
+    //строки и байты текстового набора за итерацию, в пересчёте на секунду
+    static void setThroughput(benchmark::State& state, size_t rows) {
+        state.counters["rows/s"] = benchmark::Counter(static_cast<double>(rows),
+                                                      benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["bytes/s"] = benchmark::Counter(static_cast<double>(fileBytes(dataset(rows))),
+                                                       benchmark::Counter::kIsIterationInvariantRate,
+                                                       benchmark::Counter::kIs1024);
+    }
+
+public:
+    static void BM_LoadStream(benchmark::State& state) {
+        size_t rows = state.range(0);
+        std::string filename = dataset(rows);
+
+        for (auto _ : state) {
+            auto loaded = readRecruitsFromFile(filename);
+            benchmark::DoNotOptimize(loaded.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_LoadMapped(benchmark::State& state) {
+        size_t rows = state.range(0);
+        std::string filename = dataset(rows);
+
+        for (auto _ : state) {
+            auto loaded = readRecruitsFromFileMapped(filename);
+            benchmark::DoNotOptimize(loaded.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_LoadParallel(benchmark::State& state) {
+        size_t rows = state.range(0);
+        int num_threads = state.range(1);
+        std::string filename = dataset(rows);
+
+        for (auto _ : state) {
+            auto loaded = readRecruitsFromFileParallel(filename, num_threads);
+            benchmark::DoNotOptimize(loaded.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_LoadTable(benchmark::State& state) {
+        size_t rows = state.range(0);
+        std::string filename = dataset(rows);
+
+        for (auto _ : state) {
+            auto loaded = loadRecruitTable(filename);
+            benchmark::DoNotOptimize(loaded.size());
+        }
+        setThroughput(state, rows);
+    }
+
+    //отбор с копированием пригодных призывников
+    static void BM_FilterSingleThread(benchmark::State& state) {
+        size_t rows = state.range(0);
+        const auto& data = recruits(rows);
+
+        for (auto _ : state) {
+            auto suitable = filterRecruitsSingleThread(data);
+            benchmark::DoNotOptimize(suitable.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_FilterMultiThread(benchmark::State& state) {
+        size_t rows = state.range(0);
+        int num_threads = state.range(1);
+        const auto& data = recruits(rows);
+
+        for (auto _ : state) {
+            auto suitable = filterRecruitsMultiThread(data, num_threads);
+            benchmark::DoNotOptimize(suitable.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    //тот же отбор, но только номера строк, без копирования
+    static void BM_SelectSingleThread(benchmark::State& state) {
+        size_t rows = state.range(0);
+        const auto& data = recruits(rows);
+
+        for (auto _ : state) {
+            auto selection = selectRecruitsSingleThread(data);
+            benchmark::DoNotOptimize(selection.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_SelectMultiThread(benchmark::State& state) {
+        size_t rows = state.range(0);
+        int num_threads = state.range(1);
+        const auto& data = recruits(rows);
+
+        for (auto _ : state) {
+            auto selection = selectRecruitsMultiThread(data, num_threads);
+            benchmark::DoNotOptimize(selection.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_FilterColumnsSingleThread(benchmark::State& state) {
+        size_t rows = state.range(0);
+        RecruitColumns columns = table(rows).columns();
+
+        for (auto _ : state) {
+            auto selection = selectRecruitsSingleThread(columns);
+            benchmark::DoNotOptimize(selection.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_FilterColumnsMultiThread(benchmark::State& state) {
+        size_t rows = state.range(0);
+        int num_threads = state.range(1);
+        RecruitColumns columns = table(rows).columns();
+
+        for (auto _ : state) {
+            auto selection = selectRecruitsMultiThread(columns, num_threads);
+            benchmark::DoNotOptimize(selection.data());
+        }
+        setThroughput(state, rows);
+    }
+
+    static void BM_Report(benchmark::State& state) {
+        size_t rows = state.range(0);
+        int num_threads = state.range(1);
+        RecruitColumns columns = table(rows).columns();
+
+        for (auto _ : state) {
+            RecruitReport report = buildRecruitReport(columns, num_threads);
+            benchmark::DoNotOptimize(report.fit);
+        }
+        setThroughput(state, rows);
+    }
+
+    //итерация - пакет обновлений и запрос новых пригодных. Хранилище пересоздаётся
+    //вне замера, так что каждая итерация применяет тот же пакет к таблице из rows строк
+    static void BM_IncrementalUpdates(benchmark::State& state) {
+        size_t rows = state.range(0);
+        size_t batch_updates = state.range(1);
+        const auto& initial = recruits(rows);
+        IncrementalRecruitStore store;
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            store = IncrementalRecruitStore(initial);
+            state.ResumeTiming();
+
+            size_t version = store.fitVersion();
+            for (uint64_t step = 0; step < batch_updates; ++step) {
+                RecruitUpdate update = generateRecruitUpdate(1, step, store.size());
+                if (update.newRecruit) {
+                    store.addRecruit("Новобранец_" + std::to_string(update.id), "2005.01.01");
+                } else {
+                    store.addRecord(update.id, update.specialty, update.category);
+                }
+            }
+            benchmark::DoNotOptimize(store.fitSince(version).size());
+        }
+        state.counters["updates/s"] = benchmark::Counter(static_cast<double>(batch_updates),
+                                                         benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    //те же обновления над той же копией, но после пакета пригодные пересчитываются полным проходом
+    static void BM_FullRecompute(benchmark::State& state) {
+        size_t rows = state.range(0);
+        size_t batch_updates = state.range(1);
+        const auto& initial = recruits(rows);
+        std::vector<Recruit> data;
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            data = initial;
+            state.ResumeTiming();
+
+            for (uint64_t step = 0; step < batch_updates; ++step) {
+                RecruitUpdate update = generateRecruitUpdate(1, step, data.size());
+                if (update.newRecruit) {
+                    Recruit& recruit = data.emplace_back();
+                    recruit.name = "Новобранец_" + std::to_string(update.id);
+                    recruit.birthDate = "2005.01.01";
+                } else {
+                    data[update.id].doctorRecords.emplace_back(update.specialty, update.category);
+                }
+            }
+            auto selection = selectRecruitsSingleThread(data);
+            benchmark::DoNotOptimize(selection.data());
+        }
+        state.counters["updates/s"] = benchmark::Counter(static_cast<double>(batch_updates),
+                                                         benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    //загрузка таблицы, многопоточный отбор и копирование пригодных
+    static void BM_EndToEnd(benchmark::State& state) {
+        size_t rows = state.range(0);
+        int num_threads = state.range(1);
+        std::string filename = dataset(rows);
+
+        for (auto _ : state) {
+            RecruitTable loaded = loadRecruitTable(filename);
+            auto suitable = filterRecruitsMultiThread(loaded, num_threads);
+            benchmark::DoNotOptimize(suitable.data());
+        }
+        setThroughput(state, rows);
+    }
+};
+
+//векторы Recruit на 10M строк не помещаются в память, для них размер до 1M
+BENCHMARK(RecruitBenchmark::BM_LoadStream)
+    ->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(RecruitBenchmark::BM_LoadMapped)
+    ->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(RecruitBenchmark::BM_LoadParallel)
+    ->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {2, 4, 8}})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(RecruitBenchmark::BM_LoadTable)
+    ->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(RecruitBenchmark::BM_FilterSingleThread)
+    ->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_FilterMultiThread)
+    ->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {2, 4, 8}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_SelectSingleThread)
+    ->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_SelectMultiThread)
+    ->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {2, 4, 8}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_FilterColumnsSingleThread)
+    ->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_FilterColumnsMultiThread)
+    ->ArgsProduct({benchmark::CreateRange(1000, 10000000, 10), {2, 4, 8}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_Report)
+    ->ArgsProduct({benchmark::CreateRange(1000, 10000000, 10), {1, 4}})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_IncrementalUpdates)
+    ->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {1000}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_FullRecompute)
+    ->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {1000}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(RecruitBenchmark::BM_EndToEnd)
+    ->ArgsProduct({benchmark::CreateRange(1000, 10000000, 10), {4}})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
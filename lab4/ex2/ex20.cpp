@@ -1,167 +1,402 @@
+#include "recruit_index.h"
+#include "recruit_query.h"
+#include "recruit_stream.h"
+#include "recruit_binary.h"
+#include "recruit_arena.h"
+#include "recruit_generator.h"
+#include "recruit_incremental.h"
+#include "recruit_stats.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <fstream>
-#include <sstream>
 #include <chrono>
 #include <thread>
-#include <mutex>
 #include <algorithm>
+#include <iomanip>
+#include <atomic>
+#include <memory_resource>
 
-struct Recruit {
-    std::string name;
-    std::string birthDate;
-    std::vector<std::pair<std::string, std::string>> doctorRecords;
-    
-    bool isFitForService() const {
-        for (const auto& record : doctorRecords) {
-            if (record.second == "A") {
-                return true;
-            }
-        }
-        return false;
+//ресурс, считающий выделения памяти и передающий их дальше в upstream:
+//сколько раз загрузка пакета обращается к куче
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    std::atomic<size_t> allocations{0};
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return upstream->allocate(bytes, alignment);
     }
-    
-    void print() const {
-        std::cout << "Имя: " << name << ", Дата рождения: " << birthDate;
-        std::cout << ", Записи врачей: ";
-        for (const auto& record : doctorRecords) {
-            std::cout << "(" << record.first << ": " << record.second << ") ";
-        }
-        std::cout << ", Пригоден: " << (isFitForService() ? "Да" : "Нет") << std::endl;
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
     }
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* resource = std::pmr::new_delete_resource())
+        : upstream(resource) {}
+
+    size_t count() const { return allocations.load(std::memory_order_relaxed); }
 };
 
-std::mutex dataMutex;
-std::vector<Recruit> suitableRecruits;
-std::vector<Recruit> allRecruits;
+template<typename Func>
+long long measureMs(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
 
-std::vector<Recruit> readRecruitsFromFile(const std::string& filename) {
-    std::vector<Recruit> recruits;
-    std::ifstream file(filename);
+//статическое разбиение с созданием потоков на каждый вызов против постоянного пула
+void benchmarkThreadPool(const std::vector<Recruit>& recruits, const SelectionVector& expected) {
+    constexpr int QUERIES = 10;
     
-    if (!file.is_open()) {
-        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
-        return recruits;
-    }
+    std::cout << "\n=== Пул с воровством работы против статического разбиения (" 
+              << QUERIES << " запросов) ===" << std::endl;
+    //ширина заголовков в байтах: кириллица занимает по два байта на символ
+    std::cout << std::left << std::setw(14) << "Потоки" 
+              << std::setw(30) << "Статически, мс" 
+              << std::setw(17) << "Пул, мс" << "Совпадает" << std::endl;
     
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        Recruit recruit;
-        
-        if (!(iss >> recruit.name >> recruit.birthDate)) {
-            continue;
-        }
+    for (int numThreads : {1, 2, 4, 8, 16}) {
+        SelectionVector staticResult, poolResult;
+        long long staticMs = measureMs([&] {
+            for (int q = 0; q < QUERIES; ++q) {
+                staticResult = selectRecruitsMultiThread(recruits, numThreads);
+            }
+        });
         
-        std::string specialty, category;
-        while (iss >> specialty >> category) {
-            recruit.doctorRecords.emplace_back(specialty, category);
-        }
+        WorkStealingPool pool(numThreads);
+        long long poolMs = measureMs([&] {
+            for (int q = 0; q < QUERIES; ++q) {
+                poolResult = selectRecruitsPool(pool, recruits);
+            }
+        });
         
-        recruits.push_back(recruit);
+        std::cout << std::left << std::setw(8) << numThreads 
+                  << std::setw(18) << staticMs 
+                  << std::setw(12) << poolMs 
+                  << (staticResult == expected && poolResult == expected ? "да" : "НЕТ") << std::endl;
     }
-    
-    file.close();
-    return recruits;
 }
 
-//однопоточная фильтрация
-std::vector<Recruit> filterRecruitsSingleThread(const std::vector<Recruit>& recruits) {
-    std::vector<Recruit> suitable;
+//обычные аллокации на каждую строку против арены на весь пакет
+void benchmarkArena(const std::string& filename, const std::vector<Recruit>& expected) {
+    std::cout << "\n=== Арена для строк и записей ===" << std::endl;
     
-    for (const auto& recruit : recruits) {
-        if (recruit.isFitForService()) {
-            suitable.push_back(recruit);
-        }
+    //строки и записи каждого призывника выделяются из counting по отдельности;
+    //вектор резервируется по числу строк, как и в арене, чтобы сравнивались
+    //только аллокации строк и записей
+    CountingResource heapCounter;
+    std::pmr::vector<Recruit> heapRecruits(&heapCounter);
+    long long heapLoadMs = measureMs([&] {
+        MappedFile file(filename);
+        std::string_view text = file.data();
+        heapRecruits.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+        RecruitVectorSink sink{heapRecruits};
+        parseRecruitText(file.data(), sink);
+    });
+    size_t heapCount = heapCounter.count();
+    
+    CountingResource arenaCounter;
+    RecruitBatch batch(1 << 20, &arenaCounter);
+    size_t arenaBefore = arenaCounter.count();
+    long long arenaLoadMs = measureMs([&] { readRecruitsIntoArena(filename, batch); });
+    size_t arenaCount = arenaCounter.count() - arenaBefore;
+    
+    //повторная загрузка в тот же пакет: арена уже нужного размера
+    size_t reuseBefore = arenaCounter.count();
+    long long reuseLoadMs = measureMs([&] { readRecruitsIntoArena(filename, batch); });
+    size_t reuseCount = arenaCounter.count() - reuseBefore;
+    
+    bool same = batch.size() == expected.size();
+    for (size_t i = 0; same && i < batch.size(); ++i) {
+        same = batch[i] == expected[i];
     }
     
-    return suitable;
+    long long heapFreeMs = measureMs([&] { std::pmr::vector<Recruit>(&heapCounter).swap(heapRecruits); });
+    long long arenaFreeMs = measureMs([&] { batch.clear(); });
+    
+    std::cout << "Куча:             загрузка " << heapLoadMs << " мс, освобождение " << heapFreeMs 
+              << " мс, аллокаций: " << heapCount << std::endl;
+    std::cout << "Арена:            загрузка " << arenaLoadMs << " мс, освобождение " << arenaFreeMs 
+              << " мс, аллокаций: " << arenaCount << std::endl;
+    std::cout << "Арена, повторно:  загрузка " << reuseLoadMs << " мс, аллокаций: " << reuseCount << std::endl;
+    std::cout << (same ? "Пакет в арене совпадает с исходными данными" : "Внимание: пакет в арене расходится с исходными данными!") << std::endl;
 }
 
-void filterRecruitsRange(int start, int end) {
-    std::vector<Recruit> localSuitable;
+//«пригоден И родился в диапазоне»: индекс по годам и битовая карта против полного прохода
+void benchmarkBirthIndex(const std::vector<Recruit>& recruits, const RecruitTable& table) {
+    constexpr int SCAN_QUERIES = 10;
+    constexpr int INDEX_QUERIES = 1000;
+    uint32_t fromDay = birthDay(1995, 3, 15);
+    uint32_t toDay = birthDay(1999, 10, 1);
+    
+    std::cout << "\n=== Индекс по году рождения ===" << std::endl;
+    RecruitColumns columns = table.columns();
+    BirthYearIndex index;
+    std::vector<uint64_t> fitBitmap;
+    long long buildMs = measureMs([&] {
+        index = BirthYearIndex::build(columns);
+        fitBitmap = columns.fitnessBitmap();
+    });
+    
+    SelectionVector scanResult;
+    long long scanMs = measureMs([&] {
+        for (int q = 0; q < SCAN_QUERIES; ++q) {
+            scanResult.clear();
+            for (size_t i = 0; i < recruits.size(); ++i) {
+                uint32_t day = parseBirthDate(recruits[i].birthDate);
+                if (recruits[i].isFitForService() && day != INVALID_BIRTH_DAY && day >= fromDay && day <= toDay) {
+                    scanResult.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    });
     
-    for (int i = start; i < end && i < allRecruits.size(); ++i) {
-        if (allRecruits[i].isFitForService()) {
-            localSuitable.push_back(allRecruits[i]);
+    SelectionVector indexResult;
+    long long indexMs = measureMs([&] {
+        for (int q = 0; q < INDEX_QUERIES; ++q) {
+            indexResult = selectFitBornBetween(columns, index, fitBitmap, fromDay, toDay);
         }
-    }
+    });
     
-    std::lock_guard<std::mutex> lock(dataMutex);
-    suitableRecruits.insert(suitableRecruits.end(), localSuitable.begin(), localSuitable.end());
+    std::cout << "Построение индекса и карты пригодности: " << buildMs << " мс" << std::endl;
+    std::cout << "Полный проход: " << SCAN_QUERIES * 1000.0 / std::max<long long>(scanMs, 1) << " запросов/с" << std::endl;
+    std::cout << "По индексу:    " << INDEX_QUERIES * 1000.0 / std::max<long long>(indexMs, 1) << " запросов/с" << std::endl;
+    std::cout << "Пригодных 1995.03.15-1999.10.01: " << indexResult.size() 
+              << (indexResult == scanResult ? " (совпадает)" : " (НЕ совпадает с полным проходом)") << std::endl;
 }
 
-//многопоточная фильтрация
-std::vector<Recruit> filterRecruitsMultiThread(const std::vector<Recruit>& recruits, int numThreads = 4) {
-    suitableRecruits.clear();
-    allRecruits = recruits;
+//скомпилированный запрос против написанной вручную проверки того же условия
+void benchmarkQuery(const std::vector<Recruit>& recruits, const RecruitTable& table) {
+    constexpr int QUERIES = 10;
     
-    std::vector<std::thread> threads;
-    int chunkSize = recruits.size() / numThreads;
+    std::cout << "\n=== Составные запросы ===" << std::endl;
+    RecruitColumns columns = table.columns();
     
-    for (int i = 0; i < numThreads; ++i) {
-        int start = i * chunkSize;
-        int end = (i == numThreads - 1) ? recruits.size() : (i + 1) * chunkSize;
-        threads.emplace_back(filterRecruitsRange, start, end);
-    }
+    //простое условие: должно совпасть с fitnessBitmap и не уступать ему по скорости
+    CompiledQuery fit(categoryIs("A"), columns);
+    SelectionVector handResult, queryResult;
+    long long handMs = measureMs([&] {
+        for (int q = 0; q < QUERIES; ++q) handResult = selectRecruitsSingleThread(columns);
+    });
+    long long queryMs = measureMs([&] {
+        for (int q = 0; q < QUERIES; ++q) queryResult = selectRecruitsSingleThread(fit);
+    });
+    std::cout << "category == A, вручную:  " << handMs / QUERIES << " мс/запрос" << std::endl;
+    std::cout << "category == A, запрос:   " << queryMs / QUERIES << " мс/запрос" 
+              << (queryResult == handResult ? " (совпадает)" : " (НЕ совпадает)") << std::endl;
     
-    for (auto& thread : threads) {
-        thread.join();
-    }
+    //составное условие: годен у хирурга или ровно три записи, и родился не в 2000-2004
+    RecruitQuery complex = (hasRecord("хирург", "A") || recordCountBetween(3, 3)) && !bornBetween(2000, 2004);
+    CompiledQuery compiled(complex, columns);
+    uint32_t excludedFrom = birthDay(2000, 1, 1);
+    uint32_t excludedTo = birthDay(2004, 12, 31);
     
-    return suitableRecruits;
-}
-
-void generateTestData(const std::string& filename, int numRecruits) {
-    std::ofstream file(filename);
+    long long handComplexMs = measureMs([&] {
+        for (int q = 0; q < QUERIES; ++q) {
+            handResult.clear();
+            for (size_t i = 0; i < columns.size(); ++i) {
+                bool surgeonFit = false;
+                for (uint32_t r = columns.recordOffsets[i]; r < columns.recordOffsets[i + 1]; ++r) {
+                    surgeonFit |= (*columns.specialties)[columns.specialtyCodes[r]] == "хирург" 
+                                  && (*columns.categories)[columns.categoryCodes[r]] == "A";
+                }
+                uint32_t day = columns.birthDays[i];
+                bool excluded = day >= excludedFrom && day <= excludedTo;
+                if ((surgeonFit || columns.recordCount(i) == 3) && !excluded) {
+                    handResult.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    });
+    long long complexMs = measureMs([&] {
+        for (int q = 0; q < QUERIES; ++q) queryResult = selectRecruitsSingleThread(compiled);
+    });
+    SelectionVector multiResult = selectRecruitsMultiThread(compiled, 4);
     
-    if (!file.is_open()) {
-        std::cerr << "Ошибка создания файла: " << filename << std::endl;
-        return;
+    //эталон - построчная проверка дерева на исходных Recruit
+    SelectionVector reference;
+    for (size_t i = 0; i < recruits.size(); ++i) {
+        if (complex.matches(recruits[i])) reference.push_back(static_cast<uint32_t>(i));
     }
     
-    std::vector<std::string> names = {"Иванов", "Петров", "Сидоров", "Кузнецов", "Смирнов", 
-                                      "Попов", "Васильев", "Павлов", "Семенов", "Голубев"};
-    std::vector<std::string> specialties = {"терапевт", "хирург", "окулист", "лор", "психиатр"};
-    std::vector<std::string> categories = {"A", "Бв", "Б", "В", "Г", "Д"};
+    std::cout << "составной, вручную:      " << handComplexMs / QUERIES << " мс/запрос" << std::endl;
+    std::cout << "составной, запрос:       " << complexMs / QUERIES << " мс/запрос" << std::endl;
+    std::cout << "Отобрано: " << queryResult.size() 
+              << (queryResult == reference && multiResult == reference && handResult == reference 
+                  ? " (совпадает)" : " (НЕ совпадает с построчной проверкой)") << std::endl;
     
-    std::srand(std::time(nullptr));
+    //пустые и перевёрнутые диапазоны: скомпилированный запрос против построчной проверки
+    std::vector<std::pair<std::string, RecruitQuery>> edgeQueries = {
+        {"записей 5..3", recordCountBetween(5, 3)},
+        {"родился 2004..2000", bornBetween(2004, 2000)},
+        {"не записей 5..3", !recordCountBetween(5, 3)},
+        {"записей 1000..1000", recordCountBetween(1000, 1000)},
+        {"родился 1900..1900", bornBetween(1900, 1900)},
+        {"родился 1800..2000", bornBetween(1800, 2000)},
+        {"родился 1700..1800", bornBetween(1700, 1800)}};
+    for (const auto& [name, query] : edgeQueries) {
+        CompiledQuery edge(query, columns);
+        SelectionVector edgeReference;
+        for (size_t i = 0; i < recruits.size(); ++i) {
+            if (query.matches(recruits[i])) edgeReference.push_back(static_cast<uint32_t>(i));
+        }
+        bool same = selectRecruitsSingleThread(edge) == edgeReference 
+                    && selectRecruitsMultiThread(edge, 4) == edgeReference;
+        std::cout << name << ": отобрано " << edgeReference.size() 
+                  << (same ? " (совпадает)" : " (НЕ совпадает с построчной проверкой)") << std::endl;
+    }
+}
+
+//поток обновлений: пригодность поддерживается при каждой записи против полного пересчёта после пакета
+void benchmarkIncremental(const std::vector<Recruit>& recruits) {
+    constexpr int BATCHES = 10;
+    constexpr int BATCH_UPDATES = 1000;
+    constexpr uint64_t SEED = 15;
     
-    for (int i = 0; i < numRecruits; ++i) {
-        std::string name = names[std::rand() % names.size()] + "_" + std::to_string(i);
-        
-        int year = 1990 + std::rand() % 15;
-        int month = 1 + std::rand() % 12;
-        int day = 1 + std::rand() % 28;
-        std::string birthDate = std::to_string(year) + "." + 
-                                (month < 10 ? "0" : "") + std::to_string(month) + "." + 
-                                (day < 10 ? "0" : "") + std::to_string(day);
-        
-        file << name << " " << birthDate;
+    //каждый пакет применяется к исходным данным: хранилище и копия восстанавливаются
+    //вне замера, поэтому все пакеты - одна и та же дельта над таблицей одного размера
+    std::cout << "\n=== Инкрементальное обновление ===" << std::endl;
+    IncrementalRecruitStore store;
+    std::vector<Recruit> full;
+    
+    size_t newlyFit = 0;
+    long long incrementalMs = 0;
+    long long fullMs = 0;
+    SelectionVector fullResult;
+    for (int b = 0; b < BATCHES; ++b) {
+        uint64_t firstStep = static_cast<uint64_t>(b) * BATCH_UPDATES;
         
-        int numRecords = 1 + std::rand() % 3;
-        for (int j = 0; j < numRecords; ++j) {
-            std::string specialty = specialties[std::rand() % specialties.size()];
-            std::string category = categories[std::rand() % categories.size()];
-            file << " " << specialty << " " << category;
-        }
+        store = IncrementalRecruitStore(recruits);
+        incrementalMs += measureMs([&] {
+            size_t version = store.fitVersion();
+            for (uint64_t step = firstStep; step < firstStep + BATCH_UPDATES; ++step) {
+                RecruitUpdate update = generateRecruitUpdate(SEED, step, store.size());
+                if (update.newRecruit) {
+                    store.addRecruit("Новобранец_" + std::to_string(update.id), "2005.01.01");
+                } else {
+                    store.addRecord(update.id, update.specialty, update.category);
+                }
+            }
+            newlyFit += store.fitSince(version).size();
+        });
         
-        file << std::endl;
+        full = recruits;
+        fullMs += measureMs([&] {
+            for (uint64_t step = firstStep; step < firstStep + BATCH_UPDATES; ++step) {
+                RecruitUpdate update = generateRecruitUpdate(SEED, step, full.size());
+                if (update.newRecruit) {
+                    Recruit& recruit = full.emplace_back();
+                    recruit.name = "Новобранец_" + std::to_string(update.id);
+                    recruit.birthDate = "2005.01.01";
+                } else {
+                    full[update.id].doctorRecords.emplace_back(update.specialty, update.category);
+                }
+            }
+            fullResult = selectRecruitsSingleThread(full);
+        });
     }
     
-    file.close();
-    std::cout << "Сгенерировано " << numRecruits << " записей в файле " << filename << std::endl;
+    double updates = static_cast<double>(BATCHES) * BATCH_UPDATES;
+    std::cout << "Пакетов: " << BATCHES << " по " << BATCH_UPDATES << " обновлений" << std::endl;
+    std::cout << "Инкрементально:   " << updates * 1000.0 / std::max<long long>(incrementalMs, 1) << " обновлений/с" << std::endl;
+    std::cout << "Полный пересчёт:  " << updates * 1000.0 / std::max<long long>(fullMs, 1) << " обновлений/с" << std::endl;
+    std::cout << "Стали пригодными: " << newlyFit << ", всего пригодных в последнем пакете: " << store.fitCount() 
+              << (store.selection() == fullResult ? " (совпадает)" : " (НЕ совпадает с полным пересчётом)") << std::endl;
 }
 
-int main() {
+//потоковый режим: ex20 --stream <вход> <выход> [потоки]
+int runStreaming(const std::string& inputFile, const std::string& outputFile, int numWorkers) {
+    std::cout << "Потоковая фильтрация " << inputFile << " -> " << outputFile 
+              << " (рабочих потоков: " << numWorkers << ")" << std::endl;
+    StreamStats stats = streamFilterRecruits(inputFile, outputFile, numWorkers);
+    
+    double seconds = std::max<long long>(stats.milliseconds, 1) / 1000.0;
+    std::cout << "Обработано призывников: " << stats.recruitsRead << std::endl;
+    std::cout << "Пригодных: " << stats.recruitsSuitable << std::endl;
+    std::cout << "Время: " << stats.milliseconds << " мс" << std::endl;
+    std::cout << "Пропускная способность: " << static_cast<long long>(stats.recruitsRead / seconds) << " записей/с, "
+              << stats.bytesRead / seconds / (1024 * 1024) << " МБ/с" << std::endl;
+    std::cout << "Пиковая память: " << stats.peakRssKb / 1024 << " МБ" << std::endl;
+    return stats.succeeded ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::string(argv[1]) == "--stream") {
+        int numWorkers = argc >= 5 ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+        return runStreaming(argv[2], argv[3], numWorkers);
+    }
+    
+    if (argc >= 4 && std::string(argv[1]) == "--convert") {
+        bool converted = convertRecruitTextToBinary(argv[2], argv[3]);
+        std::cout << (converted ? "Файл преобразован: " : "Ошибка преобразования: ") << argv[3] << std::endl;
+        return converted ? 0 : 1;
+    }
+    
+    //генерация набора данных: ex20 --generate <файл> <строк> [seed] [потоки]
+    if (argc >= 4 && std::string(argv[1]) == "--generate") {
+        uint64_t seed = argc >= 5 ? std::strtoull(argv[4], nullptr, 10) : DEFAULT_GENERATOR_SEED;
+        int numThreads = argc >= 6 ? std::atoi(argv[5]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        bool generated = false;
+        long long generateMs = measureMs([&] {
+            generated = generateTestData(argv[2], std::strtoull(argv[3], nullptr, 10), seed, numThreads);
+        });
+        std::cout << "Время генерации: " << generateMs << " мс" << std::endl;
+        return generated ? 0 : 1;
+    }
+    
     std::string filename = "recruits.txt";
     generateTestData(filename, 1000000);
     
     std::cout << "\nЧтение данных из файла..." << std::endl;
-    auto recruits = readRecruitsFromFile(filename);
+    auto startRead = std::chrono::high_resolution_clock::now();
+    auto recruits = readRecruitsFromFileMapped(filename);
+    auto endRead = std::chrono::high_resolution_clock::now();
+    auto durationRead = std::chrono::duration_cast<std::chrono::milliseconds>(endRead - startRead);
     std::cout << "Прочитано " << recruits.size() << " записей о призывниках" << std::endl;
     
+    std::cout << "\n=== Сравнение загрузчиков ===" << std::endl;
+    auto startStream = std::chrono::high_resolution_clock::now();
+    auto recruitsStream = readRecruitsFromFile(filename);
+    auto endStream = std::chrono::high_resolution_clock::now();
+    auto durationStream = std::chrono::duration_cast<std::chrono::milliseconds>(endStream - startStream);
+    
+    auto startView = std::chrono::high_resolution_clock::now();
+    auto recruitsView = loadRecruitsMapped(filename);
+    auto endView = std::chrono::high_resolution_clock::now();
+    auto durationView = std::chrono::duration_cast<std::chrono::milliseconds>(endView - startView);
+    
+    std::cout << "getline/istringstream: " << durationStream.count() << " мс" << std::endl;
+    std::cout << "mmap -> Recruit:       " << durationRead.count() << " мс" << std::endl;
+    std::cout << "mmap, без копирования: " << durationView.count() << " мс" << std::endl;
+    std::cout << "Ускорение загрузки: " 
+              << static_cast<double>(durationStream.count()) / std::max<long long>(durationRead.count(), 1) << "x / "
+              << static_cast<double>(durationStream.count()) / std::max<long long>(durationView.count(), 1) << "x" << std::endl;
+    
+    auto startParallel = std::chrono::high_resolution_clock::now();
+    auto recruitsParallel = readRecruitsFromFileParallel(filename);
+    auto endParallel = std::chrono::high_resolution_clock::now();
+    auto durationParallel = std::chrono::duration_cast<std::chrono::milliseconds>(endParallel - startParallel);
+    std::cout << "mmap, многопоточно (" << std::thread::hardware_concurrency() << " потоков): " 
+              << durationParallel.count() << " мс" << std::endl;
+    
+    bool sameRecords = recruitsStream == recruits && recruitsParallel == recruits && recruitsView.size() == recruits.size();
+    for (size_t i = 0; sameRecords && i < recruitsView.size(); ++i) {
+        sameRecords = recruitsView.recruit(i) == recruits[i];
+    }
+    std::cout << (sameRecords ? "Загрузчики вернули одинаковые записи" : "Внимание: загрузчики вернули разные записи!") << std::endl;
+    recruitsStream.clear();
+    recruitsParallel.clear();
+    
+    benchmarkArena(filename, recruits);
+    
     std::cout << "\n=== Однопоточная обработка ===" << std::endl;
     auto startSingle = std::chrono::high_resolution_clock::now();
     auto suitableSingle = filterRecruitsSingleThread(recruits);
@@ -180,7 +415,16 @@ int main() {
     std::cout << "Время обработки: " << durationMulti.count() << " мс" << std::endl;
     std::cout << "Найдено пригодных призывников: " << suitableMulti.size() << std::endl;
     
-    if (suitableSingle.size() == suitableMulti.size()) {
+    //функция реентерабельна: несколько запросов могут выполняться одновременно
+    std::vector<Recruit> concurrentA, concurrentB;
+    std::thread queryA([&] { concurrentA = filterRecruitsMultiThread(recruits, 2); });
+    std::thread queryB([&] { concurrentB = filterRecruitsMultiThread(recruits, 2); });
+    queryA.join();
+    queryB.join();
+    std::cout << "Параллельные запросы: " 
+              << (concurrentA == suitableSingle && concurrentB == suitableSingle ? "совпадают" : "НЕ совпадают") << std::endl;
+    
+    if (suitableSingle == suitableMulti) {
         std::cout << "\nРезультаты обработки совпадают!" << std::endl;
     } else {
         std::cout << "\nВнимание: результаты не совпадают!" << std::endl;
@@ -189,6 +433,95 @@ int main() {
     double speedup = static_cast<double>(durationSingle.count()) / durationMulti.count();
     std::cout << "Ускорение: " << speedup << "x" << std::endl;
     
+    std::cout << "\n=== Колоночное хранилище ===" << std::endl;
+    RecruitTable table;
+    long long tableLoadMs = measureMs([&] { table = loadRecruitTable(filename); });
+    std::vector<Recruit> suitableTableSingle, suitableTableMulti;
+    long long tableSingleMs = measureMs([&] { suitableTableSingle = filterRecruitsSingleThread(table); });
+    long long tableMultiMs = measureMs([&] { suitableTableMulti = filterRecruitsMultiThread(table, 4); });
+    
+    std::cout << "Загрузка в таблицу: " << tableLoadMs << " мс" << std::endl;
+    std::cout << "Однопоточная фильтрация: " << tableSingleMs << " мс" << std::endl;
+    std::cout << "Многопоточная фильтрация: " << tableMultiMs << " мс" << std::endl;
+    
+    bool sameTable = table.size() == recruits.size() 
+                     && suitableTableSingle == suitableSingle 
+                     && suitableTableMulti == suitableSingle;
+    for (size_t i = 0; sameTable && i < table.size(); ++i) {
+        sameTable = table.recruit(i) == recruits[i];
+    }
+    std::cout << (sameTable ? "Таблица совпадает с исходными данными" : "Внимание: таблица расходится с исходными данными!") << std::endl;
+    
+    std::cout << "\n=== Двоичный колоночный формат ===" << std::endl;
+    std::string binaryFilename = "recruits.bin";
+    long long convertMs = measureMs([&] { writeRecruitBinary(table.columns(), binaryFilename); });
+    MappedRecruitTable binaryTable;
+    long long binaryLoadMs = measureMs([&] { binaryTable = MappedRecruitTable(binaryFilename); });
+    
+    std::cout << "Запись: " << convertMs << " мс" << std::endl;
+    std::cout << "Загрузка текста: " << tableLoadMs << " мс, загрузка двоичного файла: " << binaryLoadMs << " мс" << std::endl;
+    
+    bool sameBinary = binaryTable.isValid() && binaryTable.size() == table.size()
+                      && selectRecruitsSingleThread(binaryTable.columns()) == selectRecruitsSingleThread(table)
+                      && filterRecruitsMultiThread(binaryTable.columns(), 4) == suitableSingle;
+    for (size_t i = 0; sameBinary && i < binaryTable.size(); ++i) {
+        sameBinary = binaryTable.recruit(i) == recruits[i];
+    }
+    std::cout << (sameBinary ? "Двоичный файл совпадает с текстовым" : "Внимание: двоичный файл расходится с текстовым!") << std::endl;
+    
+    std::cout << "\n=== Отбор номеров строк без копирования ===" << std::endl;
+    SelectionVector selectedSingle, selectedMulti, selectedTable, selectedTableMulti;
+    long long selectSingleMs = measureMs([&] { selectedSingle = selectRecruitsSingleThread(recruits); });
+    long long selectMultiMs = measureMs([&] { selectedMulti = selectRecruitsMultiThread(recruits, 4); });
+    long long selectTableMs = measureMs([&] { selectedTable = selectRecruitsSingleThread(table); });
+    long long selectTableMultiMs = measureMs([&] { selectedTableMulti = selectRecruitsMultiThread(table, 4); });
+    
+    std::cout << "Однопоточно: " << selectSingleMs << " мс (с копированием: " << durationSingle.count() << " мс)" << std::endl;
+    std::cout << "Многопоточно: " << selectMultiMs << " мс (с копированием: " << durationMulti.count() << " мс)" << std::endl;
+    std::cout << "По таблице: " << selectTableMs << " мс, многопоточно: " << selectTableMultiMs << " мс" << std::endl;
+    
+    bool sameSelection = selectedMulti == selectedSingle 
+                         && selectedTable == selectedSingle 
+                         && selectedTableMulti == selectedSingle
+                         && materialize(recruits, selectedSingle) == suitableSingle;
+    std::cout << (sameSelection ? "Выборки совпадают" : "Внимание: выборки не совпадают!") << std::endl;
+    
+    //повторное использование исходных данных: сужение уже готовой выборки
+    auto surgeonsFit = refineSelection(selectedSingle, [&](uint32_t i) {
+        for (const auto& record : recruits[i].doctorRecords) {
+            if (record.first == "хирург" && record.second == "A") return true;
+        }
+        return false;
+    });
+    std::cout << "Из них годны по заключению хирурга: " << surgeonsFit.size() << std::endl;
+    
+    benchmarkThreadPool(recruits, selectedSingle);
+    benchmarkBirthIndex(recruits, table);
+    benchmarkQuery(recruits, table);
+    benchmarkIncremental(recruits);
+    
+    std::cout << "\n=== Ядро фильтрации (выбрано: " << fitnessKernel().name << ") ===" << std::endl;
+    RecruitColumns columns = table.columns();
+    std::vector<uint64_t> expectedBitmap((columns.size() + 63) / 64);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns.isFitForService(i)) {
+            expectedBitmap[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+    
+    std::vector<FitnessKernel> kernels = {{"scalar", matchCategoryScalar}};
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("sse4.2")) kernels.push_back({"sse4.2", matchCategorySse42});
+    if (__builtin_cpu_supports("avx2")) kernels.push_back({"avx2", matchCategoryAvx2});
+#endif
+    
+    for (const auto& kernel : kernels) {
+        std::vector<uint64_t> bitmap(expectedBitmap.size());
+        long long kernelMs = measureMs([&] { columns.fitnessBitmap(0, columns.size(), bitmap.data(), kernel.match); });
+        std::cout << kernel.name << ": " << kernelMs << " мс" 
+                  << (bitmap == expectedBitmap ? "" : " (ОШИБКА: карта не совпадает)") << std::endl;
+    }
+    
     if (!suitableSingle.empty()) {
         std::cout << "\n=== Первые 5 пригодных призывников ===" << std::endl;
         int count = std::min(5, static_cast<int>(suitableSingle.size()));
@@ -205,5 +538,36 @@ int main() {
               << (static_cast<double>(suitableSingle.size()) / recruits.size() * 100) 
               << "%" << std::endl;
     
+    //сводный отчёт за один параллельный проход против одного прохода отбора
+    RecruitReport report(columns);
+    long long reportMs = measureMs([&] { report = buildRecruitReport(columns, 4); });
+    long long scanMs = measureMs([&] { selectRecruitsMultiThread(columns, 4); });
+    std::cout << "Отчёт построен за " << reportMs << " мс (проход отбора: " << scanMs << " мс)"
+              << (report.total == recruits.size() && report.fit == suitableSingle.size() ? "" : " (ИТОГИ НЕ СОВПАДАЮТ)") 
+              << std::endl;
+    
+    std::cout << "\nПригодность по году рождения:" << std::endl;
+    for (int year = BIRTH_EPOCH_YEAR; year < BIRTH_EPOCH_YEAR + RecruitReport::YEARS; ++year) {
+        if (report.born(year) == 0) continue;
+        std::cout << "  " << year << ": " << report.born(year) << " чел., пригодных " 
+                  << std::fixed << std::setprecision(1) << report.fitRate(year) * 100 << "%" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    
+    std::cout << "\nКатегории по специальностям:" << std::endl;
+    for (size_t s = 0; s < report.specialtyCount; ++s) {
+        std::cout << "  " << (*columns.specialties)[s] << ":";
+        for (size_t c = 0; c < report.categoryCount; ++c) {
+            std::cout << " " << (*columns.categories)[c] << "=" << report.categoryCountFor(s, c);
+        }
+        std::cout << std::endl;
+    }
+    
+    std::cout << "\nЗаписей врачей на призывника:" << std::endl;
+    for (size_t k = 0; k < report.recordsPerRecruit.size(); ++k) {
+        if (report.recordsPerRecruit[k] == 0) continue;
+        std::cout << "  " << k << ": " << report.recordsPerRecruit[k] << std::endl;
+    }
+    
     return 0;
 }
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+//битовая маска записей: bit k слова k / 64 выставлен, если codes[k] == code.
+//Все варианты пишут (count + 63) / 64 слов
+inline void matchCategoryScalar(const uint8_t* codes, size_t count, uint8_t code, uint64_t* bits) {
+    for (size_t word = 0; word * 64 < count; ++word) {
+        size_t end = std::min<size_t>(64, count - word * 64);
+        uint64_t mask = 0;
+        for (size_t k = 0; k < end; ++k) {
+            mask |= static_cast<uint64_t>(codes[word * 64 + k] == code) << k;
+        }
+        bits[word] = mask;
+    }
+}
+
+//векторные ядра только для x86; на других архитектурах остаётся скалярное
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.2")))
+inline void matchCategorySse42(const uint8_t* codes, size_t count, uint8_t code, uint64_t* bits) {
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(code));
+    size_t full = count / 64;
+
+    for (size_t word = 0; word < full; ++word) {
+        const uint8_t* p = codes + word * 64;
+        uint64_t m0 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle)));
+        uint64_t m1 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), needle)));
+        uint64_t m2 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)), needle)));
+        uint64_t m3 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)), needle)));
+        bits[word] = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+    }
+
+    if (full * 64 < count) {
+        matchCategoryScalar(codes + full * 64, count - full * 64, code, bits + full);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void matchCategoryAvx2(const uint8_t* codes, size_t count, uint8_t code, uint64_t* bits) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(code));
+    size_t full = count / 64;
+
+    for (size_t word = 0; word < full; ++word) {
+        const uint8_t* p = codes + word * 64;
+        __m256i lo = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), needle);
+        __m256i hi = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), needle);
+        uint64_t low = static_cast<uint32_t>(_mm256_movemask_epi8(lo));
+        uint64_t high = static_cast<uint32_t>(_mm256_movemask_epi8(hi));
+        bits[word] = low | (high << 32);
+    }
+
+    if (full * 64 < count) {
+        matchCategoryScalar(codes + full * 64, count - full * 64, code, bits + full);
+    }
+}
+#endif
+
+using MatchCategoryFn = void (*)(const uint8_t*, size_t, uint8_t, uint64_t*);
+
+struct FitnessKernel {
+    const char* name;
+    MatchCategoryFn match;
+};
+
+//выбор ядра по возможностям процессора, определяется один раз
+inline const FitnessKernel& fitnessKernel() {
+    static const FitnessKernel kernel = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return FitnessKernel{"avx2", matchCategoryAvx2};
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return FitnessKernel{"sse4.2", matchCategorySse42};
+        }
+#endif
+        return FitnessKernel{"scalar", matchCategoryScalar};
+    }();
+    return kernel;
+}
+
+//есть ли выставленный бит в диапазоне [begin, end)
+inline bool anyBitInRange(const uint64_t* bits, uint32_t begin, uint32_t end) {
+    while (begin < end) {
+        uint32_t offset = begin & 63;
+        uint32_t width = std::min<uint32_t>(64 - offset, end - begin);
+        uint64_t mask = (width == 64) ? ~0ULL : ((1ULL << width) - 1);
+        if ((bits[begin >> 6] >> offset) & mask) {
+            return true;
+        }
+        begin += width;
+    }
+    return false;
+}
+
+//битовая карта призывников [first, last), у которых есть запись с категорией code:
+//бит i слова i / 64 относится к призывнику i. first должен быть кратен 64,
+//чтобы потоки писали в разные слова. Записи обрабатываются блоками,
+//чтобы маска записей оставалась в кэше
+inline void computeCategoryBitmap(const uint32_t* recordOffsets, const uint8_t* categoryCodes, uint8_t code,
+                                  size_t first, size_t last, uint64_t* bitmap,
+                                  MatchCategoryFn match = fitnessKernel().match) {
+    constexpr size_t BLOCK = 4096;
+    std::vector<uint64_t> recordBits;
+
+    for (size_t blockStart = first; blockStart < last; blockStart += BLOCK) {
+        size_t blockEnd = std::min(blockStart + BLOCK, last);
+        uint32_t base = recordOffsets[blockStart];
+        uint32_t recordCount = recordOffsets[blockEnd] - base;
+        recordBits.resize(recordCount / 64 + 1);
+        match(categoryCodes + base, recordCount, code, recordBits.data());
+
+        for (size_t wordStart = blockStart; wordStart < blockEnd; wordStart += 64) {
+            size_t wordEnd = std::min(wordStart + 64, blockEnd);
+            uint64_t word = 0;
+            for (size_t i = wordStart; i < wordEnd; ++i) {
+                bool found = anyBitInRange(recordBits.data(), recordOffsets[i] - base, recordOffsets[i + 1] - base);
+                word |= static_cast<uint64_t>(found) << (i - wordStart);
+            }
+            bitmap[wordStart / 64] = word;
+        }
+    }
+}
+
+//вызывает func(i) для каждого выставленного бита в диапазоне слов
+template <typename Func>
+void forEachSetBit(const uint64_t* bitmap, size_t firstWord, size_t lastWord, Func func) {
+    for (size_t w = firstWord; w < lastWord; ++w) {
+        uint64_t word = bitmap[w];
+        while (word != 0) {
+            func(w * 64 + std::countr_zero(word));
+            word &= word - 1;
+        }
+    }
+}
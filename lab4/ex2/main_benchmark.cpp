@@ -0,0 +1,16 @@
+#include "benchmark_recruits.h"
+#include <iostream>
+
+int main(int argc, char** argv) {
+    std::cout << "   GOOGLE BENCHMARK - RECRUIT PIPELINE" << std::endl;
+    std::cout << "Testing: Load, Single-thread filter, Multi-thread filter, End-to-end" << std::endl;
+    std::cout << "Rows: 1K - 10M | Threads: 2, 4, 8" << std::endl;
+
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+
+    std::cout << "   Benchmark completed successfully!" << std::endl;
+
+    return 0;
+}
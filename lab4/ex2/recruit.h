@@ -0,0 +1,86 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <memory_resource>
+
+//строки и записи врачей берут память из polymorphic_allocator: по умолчанию
+//это обычная куча, а внутри std::pmr::vector<Recruit> - ресурс этого вектора
+struct Recruit {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string name;
+    std::pmr::string birthDate;
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> doctorRecords;
+
+    Recruit() = default;
+    Recruit(const Recruit&) = default;
+    Recruit(Recruit&&) = default;
+    Recruit& operator=(const Recruit&) = default;
+    Recruit& operator=(Recruit&&) = default;
+
+    explicit Recruit(const allocator_type& alloc)
+        : name(alloc), birthDate(alloc), doctorRecords(alloc) {}
+
+    Recruit(const Recruit& other, const allocator_type& alloc)
+        : name(other.name, alloc), birthDate(other.birthDate, alloc), doctorRecords(other.doctorRecords, alloc) {}
+
+    Recruit(Recruit&& other, const allocator_type& alloc)
+        : name(std::move(other.name), alloc), birthDate(std::move(other.birthDate), alloc),
+          doctorRecords(std::move(other.doctorRecords), alloc) {}
+
+    bool isFitForService() const {
+        for (const auto& record : doctorRecords) {
+            if (record.second == "A") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void print() const {
+        std::cout << "Имя: " << name << ", Дата рождения: " << birthDate;
+        std::cout << ", Записи врачей: ";
+        for (const auto& record : doctorRecords) {
+            std::cout << "(" << record.first << ": " << record.second << ") ";
+        }
+        std::cout << ", Пригоден: " << (isFitForService() ? "Да" : "Нет") << std::endl;
+    }
+
+    bool operator==(const Recruit&) const = default;
+};
+
+//эталонное чтение через getline/istringstream
+inline std::vector<Recruit> readRecruitsFromFile(const std::string& filename) {
+    std::vector<Recruit> recruits;
+    std::ifstream file(filename);
+
+    if (!file.is_open()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return recruits;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        Recruit recruit;
+
+        if (!(iss >> recruit.name >> recruit.birthDate)) {
+            continue;
+        }
+
+        std::string specialty, category;
+        while (iss >> specialty >> category) {
+            recruit.doctorRecords.emplace_back(specialty, category);
+        }
+
+        recruits.push_back(std::move(recruit));
+    }
+
+    file.close();
+    return recruits;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "recruit_loader.h"
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+
+//пакет призывников в одной арене: строки и векторы записей берутся из
+//monotonic_buffer_resource и освобождаются все сразу вместе с пакетом.
+//Recruit, перемещённый из пакета, продолжает ссылаться на арену,
+//поэтому наружу их нужно копировать
+class RecruitBatch {
+private:
+    //арена и вектор живут в куче, чтобы перемещение пакета не меняло их адрес.
+    //Первый блок арены принадлежит пакету и переживает clear(), поэтому
+    //повторная загрузка в тот же пакет не обращается к куче вовсе.
+    //Первый блок и дополнительные блоки арены берутся из upstream
+    struct Storage {
+        std::pmr::memory_resource* upstream;
+        size_t initialBytes;
+        void* initialBlock;
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<Recruit> items{&arena};
+
+        Storage(size_t bytes, std::pmr::memory_resource* resource)
+            : upstream(resource), initialBytes(bytes),
+              initialBlock(resource->allocate(bytes, alignof(std::max_align_t))),
+              arena(initialBlock, bytes, resource) {}
+
+        ~Storage() {
+            items = std::pmr::vector<Recruit>(&arena);
+            arena.release();
+            upstream->deallocate(initialBlock, initialBytes, alignof(std::max_align_t));
+        }
+
+        Storage(const Storage&) = delete;
+        Storage& operator=(const Storage&) = delete;
+    };
+
+    std::pmr::memory_resource* upstream;
+    std::unique_ptr<Storage> storage;
+    size_t capacity;
+
+public:
+    explicit RecruitBatch(size_t initialBytes = 1 << 20,
+                          std::pmr::memory_resource* upstreamResource = std::pmr::get_default_resource())
+        : upstream(upstreamResource), storage(std::make_unique<Storage>(initialBytes, upstreamResource)),
+          capacity(initialBytes) {}
+
+private:
+    //после перемещения storage пуст: такой пакет ведёт себя как пустой,
+    //а арена создаётся заново при первом изменении
+    Storage& ensureStorage() {
+        if (!storage) {
+            storage = std::make_unique<Storage>(capacity, upstream);
+        }
+        return *storage;
+    }
+
+public:
+    //освобождает всех призывников разом, первый блок арены остаётся
+    void clear() {
+        if (!storage) return;
+        storage->items = std::pmr::vector<Recruit>(&storage->arena);
+        storage->arena.release();
+    }
+
+    //если первый блок меньше bytes, арена пересоздаётся с блоком нужного размера
+    void reserveBytes(size_t bytes) {
+        if (bytes > capacity) {
+            storage.reset();
+            capacity = bytes;
+        }
+        ensureStorage();
+    }
+
+    std::pmr::vector<Recruit>& recruits() { return ensureStorage().items; }
+    const std::pmr::vector<Recruit>& recruits() const {
+        static const std::pmr::vector<Recruit> empty;
+        return storage ? storage->items : empty;
+    }
+    size_t size() const { return storage ? storage->items.size() : 0; }
+    const Recruit& operator[](size_t index) const { return storage->items[index]; }
+    std::pmr::memory_resource* resource() { return &ensureStorage().arena; }
+};
+
+//накапливает записи текущей строки и создаёт вектор записей точного размера,
+//чтобы рост вектора не оставлял в арене брошенных буферов
+struct RecruitArenaSink {
+    std::pmr::vector<Recruit>& recruits;
+    std::vector<std::pair<std::string_view, std::string_view>> pendingRecords;
+
+    void flush() {
+        if (recruits.empty()) return;
+        auto& records = recruits.back().doctorRecords;
+        records.reserve(pendingRecords.size());
+        for (const auto& [specialty, category] : pendingRecords) {
+            records.emplace_back(specialty, category);
+        }
+        pendingRecords.clear();
+    }
+
+    void addRecruit(std::string_view name, std::string_view birthDate) {
+        flush();
+        Recruit& recruit = recruits.emplace_back();
+        recruit.name.assign(name);
+        recruit.birthDate.assign(birthDate);
+    }
+
+    void addRecord(std::string_view specialty, std::string_view category) {
+        pendingRecords.emplace_back(specialty, category);
+    }
+};
+
+//чтение файла целиком в арену пакета; содержимое пакета заменяется
+inline void readRecruitsIntoArena(const std::string& filename, RecruitBatch& batch) {
+    batch.clear();
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return;
+    }
+
+    //оценка арены: сами Recruit, в среднем две записи на строку и строки длиннее SSO
+    std::string_view text = file.data();
+    size_t lines = std::count(text.begin(), text.end(), '\n') + 1;
+    batch.reserveBytes(lines * (sizeof(Recruit) + 2 * sizeof(Recruit::allocator_type) 
+                                + 2 * sizeof(std::pair<std::pmr::string, std::pmr::string>)) + text.size() / 2);
+    batch.recruits().reserve(lines);
+
+    RecruitArenaSink sink{batch.recruits(), {}};
+    parseRecruitText(text, sink);
+    sink.flush();
+}
+
+inline RecruitBatch readRecruitsIntoArena(const std::string& filename) {
+    RecruitBatch batch;
+    readRecruitsIntoArena(filename, batch);
+    return batch;
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "recruit_table.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+//двоичный колоночный формат призывников.
+//После заголовка идут секции, каждая выровнена на 8 байт:
+//  recordOffsets  uint32_t[recruitCount + 1]
+//  specialtyCodes uint8_t[recordCount]
+//  categoryCodes  uint8_t[recordCount]
+//  nameOffsets    uint64_t[recruitCount + 1]
+//  names          char[namesSize]
+//  dateOffsets    uint64_t[recruitCount + 1]
+//  dates          char[datesSize]
+//  birthDays      uint32_t[recruitCount]
+//  dictionary     uint32_t[specialtyCount + categoryCount + 1] смещений, затем строки
+//Порядок байт - родной для машины, файл предназначен для повторных запусков на ней же
+constexpr char RECRUIT_BINARY_MAGIC[8] = {'R', 'C', 'R', 'T', 'B', 'I', 'N', '\0'};
+//версия 2: добавлена колонка birthDays
+constexpr uint32_t RECRUIT_BINARY_VERSION = 2;
+
+struct RecruitBinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t recruitCount;
+    uint64_t recordCount;
+    uint64_t namesSize;
+    uint64_t datesSize;
+    uint32_t specialtyCount;
+    uint32_t categoryCount;
+    uint64_t recordOffsetsPos;
+    uint64_t specialtyCodesPos;
+    uint64_t categoryCodesPos;
+    uint64_t nameOffsetsPos;
+    uint64_t namesPos;
+    uint64_t dateOffsetsPos;
+    uint64_t datesPos;
+    uint64_t birthDaysPos;
+    uint64_t dictionaryPos;
+    uint64_t dictionarySize;
+};
+
+inline uint64_t alignRecruitSection(uint64_t pos) {
+    return (pos + 7) & ~static_cast<uint64_t>(7);
+}
+
+inline bool writeRecruitBinary(const RecruitColumns& columns, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "Ошибка создания файла: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<uint32_t> dictionaryOffsets{0};
+    std::string dictionaryStrings;
+    for (const StringDictionary* dictionary : {columns.specialties, columns.categories}) {
+        for (size_t code = 0; dictionary != nullptr && code < dictionary->size(); ++code) {
+            dictionaryStrings += (*dictionary)[static_cast<uint8_t>(code)];
+            dictionaryOffsets.push_back(static_cast<uint32_t>(dictionaryStrings.size()));
+        }
+    }
+
+    RecruitBinaryHeader header{};
+    std::memcpy(header.magic, RECRUIT_BINARY_MAGIC, sizeof(header.magic));
+    header.version = RECRUIT_BINARY_VERSION;
+    header.headerSize = sizeof(RecruitBinaryHeader);
+    header.recruitCount = columns.size();
+    header.recordCount = columns.categoryCodes.size();
+    header.namesSize = columns.names.size();
+    header.datesSize = columns.dates.size();
+    header.specialtyCount = columns.specialties ? static_cast<uint32_t>(columns.specialties->size()) : 0;
+    header.categoryCount = columns.categories ? static_cast<uint32_t>(columns.categories->size()) : 0;
+
+    uint64_t pos = alignRecruitSection(sizeof(RecruitBinaryHeader));
+    auto place = [&pos](uint64_t& sectionPos, uint64_t bytes) {
+        sectionPos = pos;
+        pos = alignRecruitSection(pos + bytes);
+    };
+    place(header.recordOffsetsPos, (header.recruitCount + 1) * sizeof(uint32_t));
+    place(header.specialtyCodesPos, header.recordCount);
+    place(header.categoryCodesPos, header.recordCount);
+    place(header.nameOffsetsPos, (header.recruitCount + 1) * sizeof(uint64_t));
+    place(header.namesPos, header.namesSize);
+    place(header.dateOffsetsPos, (header.recruitCount + 1) * sizeof(uint64_t));
+    place(header.datesPos, header.datesSize);
+    place(header.birthDaysPos, header.recruitCount * sizeof(uint32_t));
+    header.dictionarySize = dictionaryOffsets.size() * sizeof(uint32_t) + dictionaryStrings.size();
+    place(header.dictionaryPos, header.dictionarySize);
+
+    uint64_t written = 0;
+    auto writeAt = [&file, &written](uint64_t sectionPos, const void* data, uint64_t bytes) {
+        static const char zeros[8] = {};
+        file.write(zeros, static_cast<std::streamsize>(sectionPos - written));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written = sectionPos + bytes;
+    };
+
+    //пустая таблица тоже хранит recordOffsets и смещения строк из одного нуля
+    const uint32_t zeroRecordOffset = 0;
+    const uint64_t zeroStringOffset = 0;
+    bool empty = columns.recordOffsets.empty();
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.recordOffsetsPos, empty ? &zeroRecordOffset : columns.recordOffsets.data(),
+            (header.recruitCount + 1) * sizeof(uint32_t));
+    writeAt(header.specialtyCodesPos, columns.specialtyCodes.data(), header.recordCount);
+    writeAt(header.categoryCodesPos, columns.categoryCodes.data(), header.recordCount);
+    writeAt(header.nameOffsetsPos, empty ? &zeroStringOffset : columns.nameOffsets.data(),
+            (header.recruitCount + 1) * sizeof(uint64_t));
+    writeAt(header.namesPos, columns.names.data(), header.namesSize);
+    writeAt(header.dateOffsetsPos, empty ? &zeroStringOffset : columns.dateOffsets.data(),
+            (header.recruitCount + 1) * sizeof(uint64_t));
+    writeAt(header.datesPos, columns.dates.data(), header.datesSize);
+    writeAt(header.birthDaysPos, columns.birthDays.data(), header.recruitCount * sizeof(uint32_t));
+    writeAt(header.dictionaryPos, dictionaryOffsets.data(), dictionaryOffsets.size() * sizeof(uint32_t));
+    file.write(dictionaryStrings.data(), static_cast<std::streamsize>(dictionaryStrings.size()));
+
+    return static_cast<bool>(file);
+}
+
+//конвертер из текстового формата recruits.txt
+inline bool convertRecruitTextToBinary(const std::string& textFile, const std::string& binaryFile) {
+    RecruitTable table = loadRecruitTable(textFile);
+    return writeRecruitBinary(table.columns(), binaryFile);
+}
+
+//таблица, колонки которой указывают прямо в отображённый двоичный файл.
+//Разбора нет: проверяется заголовок и читаются только словари
+class MappedRecruitTable {
+private:
+    MappedFile file;
+    RecruitColumns layout;
+    StringDictionary specialties;
+    StringDictionary categories;
+    bool valid = false;
+
+    template <typename T>
+    std::span<const T> section(uint64_t pos, uint64_t count) const {
+        return {reinterpret_cast<const T*>(file.data().data() + pos), count};
+    }
+
+    //смещения не убывают и заканчиваются ровно на размере секции,
+    //значит каждое лежит внутри неё
+    template <typename T>
+    static bool offsetsValid(std::span<const T> offsets, uint64_t end) {
+        for (size_t i = 1; i < offsets.size(); ++i) {
+            if (offsets[i - 1] > offsets[i]) {
+                return false;
+            }
+        }
+        return offsets.back() == end;
+    }
+
+    static bool codesValid(std::span<const uint8_t> codes, size_t dictionarySize) {
+        return std::all_of(codes.begin(), codes.end(), [dictionarySize](uint8_t code) { return code < dictionarySize; });
+    }
+
+    bool load(const std::string& filename) {
+        file = MappedFile(filename);
+        if (!file.isOpen()) {
+            std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+            return false;
+        }
+
+        std::string_view data = file.data();
+        RecruitBinaryHeader header;
+        if (data.size() < sizeof(header)) {
+            std::cerr << "Повреждённый двоичный файл: " << filename << std::endl;
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, RECRUIT_BINARY_MAGIC, sizeof(header.magic)) != 0
+            || header.headerSize != sizeof(header)) {
+            std::cerr << "Неизвестный формат файла: " << filename << std::endl;
+            return false;
+        }
+        if (header.version != RECRUIT_BINARY_VERSION) {
+            std::cerr << "Неподдерживаемая версия двоичного файла " << filename
+                      << ": " << header.version << std::endl;
+            return false;
+        }
+
+        auto fits = [&data](uint64_t pos, uint64_t bytes) {
+            return pos % 8 == 0 && pos <= data.size() && bytes <= data.size() - pos;
+        };
+        uint64_t dictionaryEntries = uint64_t(header.specialtyCount) + header.categoryCount;
+        //ограничение до умножений ниже: иначе (recruitCount + 1) * 8 переполняется
+        if (header.recruitCount >= data.size() / sizeof(uint64_t)
+            || !fits(header.recordOffsetsPos, (header.recruitCount + 1) * sizeof(uint32_t))
+            || !fits(header.specialtyCodesPos, header.recordCount)
+            || !fits(header.categoryCodesPos, header.recordCount)
+            || !fits(header.nameOffsetsPos, (header.recruitCount + 1) * sizeof(uint64_t))
+            || !fits(header.namesPos, header.namesSize)
+            || !fits(header.dateOffsetsPos, (header.recruitCount + 1) * sizeof(uint64_t))
+            || !fits(header.datesPos, header.datesSize)
+            || !fits(header.birthDaysPos, header.recruitCount * sizeof(uint32_t))
+            || !fits(header.dictionaryPos, header.dictionarySize)
+            || header.specialtyCount > 256 || header.categoryCount > 256
+            || (dictionaryEntries + 1) * sizeof(uint32_t) > header.dictionarySize) {
+            std::cerr << "Повреждённый двоичный файл: " << filename << std::endl;
+            return false;
+        }
+
+        layout.recordOffsets = section<uint32_t>(header.recordOffsetsPos, header.recruitCount + 1);
+        layout.specialtyCodes = section<uint8_t>(header.specialtyCodesPos, header.recordCount);
+        layout.categoryCodes = section<uint8_t>(header.categoryCodesPos, header.recordCount);
+        layout.nameOffsets = section<uint64_t>(header.nameOffsetsPos, header.recruitCount + 1);
+        layout.names = data.substr(header.namesPos, header.namesSize);
+        layout.dateOffsets = section<uint64_t>(header.dateOffsetsPos, header.recruitCount + 1);
+        layout.dates = data.substr(header.datesPos, header.datesSize);
+        layout.birthDays = section<uint32_t>(header.birthDaysPos, header.recruitCount);
+
+        if (!offsetsValid(layout.recordOffsets, header.recordCount)
+            || !offsetsValid(layout.nameOffsets, header.namesSize)
+            || !offsetsValid(layout.dateOffsets, header.datesSize)) {
+            std::cerr << "Повреждённый двоичный файл: " << filename << std::endl;
+            return false;
+        }
+
+        std::span<const uint32_t> offsets = section<uint32_t>(header.dictionaryPos, dictionaryEntries + 1);
+        std::string_view strings = data.substr(header.dictionaryPos + offsets.size_bytes(),
+                                               header.dictionarySize - offsets.size_bytes());
+        for (uint64_t i = 0; i < dictionaryEntries; ++i) {
+            if (offsets[i] > offsets[i + 1] || offsets[i + 1] > strings.size()) {
+                std::cerr << "Повреждённый двоичный файл: " << filename << std::endl;
+                return false;
+            }
+            std::string_view value = strings.substr(offsets[i], offsets[i + 1] - offsets[i]);
+            if (i < header.specialtyCount) {
+                specialties.intern(value);
+            } else {
+                categories.intern(value);
+            }
+        }
+
+        //коды сверяются с уже прочитанными словарями: recruit() индексирует их без проверок
+        if (!codesValid(layout.specialtyCodes, specialties.size())
+            || !codesValid(layout.categoryCodes, categories.size())) {
+            std::cerr << "Повреждённый двоичный файл: " << filename << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+public:
+    MappedRecruitTable() = default;
+
+    explicit MappedRecruitTable(const std::string& filename) {
+        valid = load(filename);
+        if (!valid) {
+            layout = RecruitColumns{};
+        }
+    }
+
+    bool isValid() const { return valid; }
+
+    RecruitColumns columns() const {
+        RecruitColumns view = layout;
+        view.specialties = &specialties;
+        view.categories = &categories;
+        view.fitCategory = categories.find("A");
+        return view;
+    }
+
+    size_t size() const { return layout.size(); }
+    Recruit recruit(size_t index) const { return columns().recruit(index); }
+};
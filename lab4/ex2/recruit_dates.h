@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+//день рождения хранится как число дней от 1900.01.01
+constexpr uint32_t INVALID_BIRTH_DAY = UINT32_MAX;
+constexpr int BIRTH_EPOCH_YEAR = 1900;
+constexpr int BIRTH_LAST_YEAR = 9999;    //год в дате записан четырьмя цифрами
+
+//номер дня от 1970.01.01 по григорианскому календарю (алгоритм days_from_civil)
+constexpr int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+constexpr int64_t BIRTH_EPOCH_OFFSET = daysFromCivil(BIRTH_EPOCH_YEAR, 1, 1);
+
+//упакованный день рождения по году, месяцу и дню
+constexpr uint32_t birthDay(int year, unsigned month, unsigned day) {
+    return static_cast<uint32_t>(daysFromCivil(year, month, day) - BIRTH_EPOCH_OFFSET);
+}
+
+//год по упакованному дню рождения (обратный алгоритм civil_from_days, только год)
+constexpr int yearFromBirthDay(uint32_t days) {
+    const int64_t z = static_cast<int64_t>(days) + BIRTH_EPOCH_OFFSET + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(z - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthPrime = (5 * dayOfYear + 2) / 153;
+    const int year = static_cast<int>(yearOfEra + era * 400);
+    return monthPrime >= 10 ? year + 1 : year;
+}
+
+//разбор даты фиксированной ширины "YYYY.MM.DD" без потоков и исключений;
+//для любой другой строки или несуществующей даты - INVALID_BIRTH_DAY
+constexpr uint32_t parseBirthDate(std::string_view text) {
+    if (text.size() != 10 || text[4] != '.' || text[7] != '.') {
+        return INVALID_BIRTH_DAY;
+    }
+
+    unsigned digits[8];
+    constexpr int positions[8] = {0, 1, 2, 3, 5, 6, 8, 9};
+    for (int i = 0; i < 8; ++i) {
+        digits[i] = static_cast<unsigned char>(text[positions[i]]) - '0';
+        if (digits[i] > 9) {
+            return INVALID_BIRTH_DAY;
+        }
+    }
+
+    int year = static_cast<int>(digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3]);
+    unsigned month = digits[4] * 10 + digits[5];
+    unsigned day = digits[6] * 10 + digits[7];
+    if (year < BIRTH_EPOCH_YEAR || month < 1 || month > 12 || day < 1) {
+        return INVALID_BIRTH_DAY;
+    }
+
+    constexpr unsigned monthDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > monthDays[month - 1] + (month == 2 && leap)) {
+        return INVALID_BIRTH_DAY;
+    }
+
+    return birthDay(year, month, day);
+}
+
+static_assert(parseBirthDate("1900.01.01") == 0);
+static_assert(parseBirthDate("2000.03.01") == birthDay(2000, 3, 1));
+static_assert(birthDay(2000, 3, 1) - birthDay(2000, 2, 28) == 2);
+static_assert(parseBirthDate("2001.02.29") == INVALID_BIRTH_DAY);
+static_assert(yearFromBirthDay(parseBirthDate("2004.12.31")) == 2004);
+static_assert(yearFromBirthDay(parseBirthDate("1990.01.01")) == 1990);
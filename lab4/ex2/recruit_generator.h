@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+constexpr uint64_t DEFAULT_GENERATOR_SEED = 20240101;
+
+//счётчиковый генератор splitmix64: поток случайных чисел задаётся парой
+//(seed, номер строки), поэтому строка не зависит ни от потока, ни от порядка генерации
+class RecruitRandom {
+private:
+    uint64_t state;
+
+    static constexpr uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    RecruitRandom(uint64_t seed, uint64_t row) : state(mix(seed ^ mix(row + 0x9e3779b97f4a7c15ULL))) {}
+
+    uint64_t next() {
+        state += 0x9e3779b97f4a7c15ULL;
+        return mix(state);
+    }
+
+    //число в [0, bound) без деления
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+};
+
+constexpr std::array<std::string_view, 10> GENERATOR_NAMES = {"Иванов", "Петров", "Сидоров", "Кузнецов", "Смирнов",
+                                                              "Попов", "Васильев", "Павлов", "Семенов", "Голубев"};
+constexpr std::array<std::string_view, 5> GENERATOR_SPECIALTIES = {"терапевт", "хирург", "окулист", "лор", "психиатр"};
+constexpr std::array<std::string_view, 6> GENERATOR_CATEGORIES = {"A", "Бв", "Б", "В", "Г", "Д"};
+
+//одна строка файла с призывником номер row, возвращает конец записанного
+inline char* formatRecruitLine(char* out, uint64_t seed, uint64_t row) {
+    const auto& names = GENERATOR_NAMES;
+    const auto& specialties = GENERATOR_SPECIALTIES;
+    const auto& categories = GENERATOR_CATEGORIES;
+
+    auto put = [&out](std::string_view text) {
+        std::memcpy(out, text.data(), text.size());
+        out += text.size();
+    };
+    auto putTwoDigits = [&out](uint32_t value) {
+        *out++ = static_cast<char>('0' + value / 10);
+        *out++ = static_cast<char>('0' + value % 10);
+    };
+
+    RecruitRandom random(seed, row);
+    put(names[random.below(names.size())]);
+    *out++ = '_';
+    out = std::to_chars(out, out + 20, row).ptr;
+
+    uint32_t year = 1990 + random.below(15);
+    uint32_t month = 1 + random.below(12);
+    uint32_t day = 1 + random.below(28);
+    *out++ = ' ';
+    putTwoDigits(year / 100);
+    putTwoDigits(year % 100);
+    *out++ = '.';
+    putTwoDigits(month);
+    *out++ = '.';
+    putTwoDigits(day);
+
+    uint32_t numRecords = 1 + random.below(3);
+    for (uint32_t j = 0; j < numRecords; ++j) {
+        *out++ = ' ';
+        put(specialties[random.below(specialties.size())]);
+        *out++ = ' ';
+        put(categories[random.below(categories.size())]);
+    }
+
+    *out++ = '\n';
+    return out;
+}
+
+//верхняя граница длины строки: фамилия, номер, дата и три записи
+constexpr size_t MAX_RECRUIT_LINE = 16 + 1 + 20 + 11 + 3 * (1 + 16 + 1 + 4) + 1;
+
+//генерация numRecruits строк в numThreads потоков. Строки нарезаются на блоки
+//по blockRows; за раунд каждый поток форматирует свой блок в собственный буфер,
+//после барьера смещения блоков считаются префиксной суммой, и каждый поток
+//пишет свой буфер через pwrite в непересекающийся участок файла, не дожидаясь остальных.
+//Буфер рассчитан на blockRows строк наибольшей длины: при 4096 строках это около
+//600 КБ на поток. Для одного seed файл побайтно одинаков при любом числе потоков
+inline bool generateTestData(const std::string& filename, size_t numRecruits,
+                             uint64_t seed = DEFAULT_GENERATOR_SEED,
+                             int numThreads = std::max(1u, std::thread::hardware_concurrency()),
+                             size_t blockRows = 1 << 12) {
+    if (numThreads < 1 || blockRows == 0) {
+        std::cerr << "Число потоков и размер блока должны быть положительными: " 
+                  << numThreads << ", " << blockRows << std::endl;
+        return false;
+    }
+
+    //потоков больше, чем блоков, не нужно: лишним нечего форматировать
+    size_t numBlocks = (numRecruits + blockRows - 1) / blockRows;
+    numThreads = static_cast<int>(std::clamp<size_t>(numBlocks, 1, numThreads));
+    blockRows = std::min(blockRows, std::max<size_t>(numRecruits, 1));
+
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Ошибка создания файла: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<std::vector<char>> buffers(numThreads, std::vector<char>(blockRows * MAX_RECRUIT_LINE));
+    std::vector<size_t> blockSizes(numThreads, 0);
+    std::vector<off_t> blockOffsets(numThreads, 0);
+    off_t fileSize = 0;
+    std::atomic<bool> failed{false};
+
+    //завершение барьера: смещения блоков раунда по порядку номеров блоков
+    std::barrier formatted(numThreads, [&]() noexcept {
+        for (int t = 0; t < numThreads; ++t) {
+            blockOffsets[t] = fileSize;
+            fileSize += static_cast<off_t>(blockSizes[t]);
+        }
+    });
+
+    auto worker = [&](int threadId) {
+        std::vector<char>& buffer = buffers[threadId];
+        for (size_t round = 0; round * numThreads < numBlocks; ++round) {
+            size_t block = round * numThreads + threadId;
+            size_t first = std::min(block * blockRows, numRecruits);
+            size_t last = std::min(first + blockRows, numRecruits);
+
+            char* out = buffer.data();
+            for (size_t row = first; row < last; ++row) {
+                out = formatRecruitLine(out, seed, row);
+            }
+            blockSizes[threadId] = out - buffer.data();
+
+            formatted.arrive_and_wait();
+
+            size_t done = 0;
+            while (done < blockSizes[threadId]) {
+                ssize_t result = ::pwrite(fd, buffer.data() + done, blockSizes[threadId] - done,
+                                          blockOffsets[threadId] + static_cast<off_t>(done));
+                if (result <= 0) {
+                    failed = true;
+                    break;
+                }
+                done += result;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ::close(fd);
+    if (failed) {
+        std::cerr << "Ошибка записи в файл: " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "Сгенерировано " << numRecruits << " записей в файле " << filename << std::endl;
+    return true;
+}
+
+//обновление для потока изменений: новый призывник без записей
+//или новая запись врача у одного из уже существующих
+struct RecruitUpdate {
+    bool newRecruit;
+    uint32_t id;
+    std::string_view specialty;
+    std::string_view category;
+};
+
+//шаг step потока обновлений над таблицей из size призывников; newRecruitPercent - доля новых
+inline RecruitUpdate generateRecruitUpdate(uint64_t seed, uint64_t step, size_t size, uint32_t newRecruitPercent = 30) {
+    RecruitRandom random(seed, step);
+    RecruitUpdate update{};
+    update.newRecruit = size == 0 || random.below(100) < newRecruitPercent;
+    update.id = update.newRecruit ? static_cast<uint32_t>(size) : random.below(static_cast<uint32_t>(size));
+    update.specialty = GENERATOR_SPECIALTIES[random.below(GENERATOR_SPECIALTIES.size())];
+    update.category = GENERATOR_CATEGORIES[random.below(GENERATOR_CATEGORIES.size())];
+    return update;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "recruit_selection.h"
+#include <deque>
+#include <span>
+
+//хранилище с дозаписью: призывники и записи врачей только добавляются,
+//поэтому пригодность может лишь появиться и больше не пропадает. Состояние
+//пригодности обновляется при каждой записи, запросы не просматривают таблицу
+class IncrementalRecruitStore {
+private:
+    //deque растёт блоками: добавление не перемещает уже сохранённых призывников
+    std::deque<Recruit> rows;
+    std::vector<uint64_t> fitBitmap;
+    std::vector<uint32_t> fitOrder;    //пригодные в порядке, в котором они стали пригодными
+
+    static bool isFitRecord(std::string_view category) { return category == "A"; }
+
+    void markFit(uint32_t id) {
+        uint64_t bit = 1ULL << (id % 64);
+        if (!(fitBitmap[id / 64] & bit)) {
+            fitBitmap[id / 64] |= bit;
+            fitOrder.push_back(id);
+        }
+    }
+
+public:
+    IncrementalRecruitStore() = default;
+
+    explicit IncrementalRecruitStore(std::vector<Recruit> initial) {
+        for (auto& recruit : initial) {
+            addRecruit(std::move(recruit));
+        }
+    }
+
+    uint32_t addRecruit(Recruit recruit) {
+        uint32_t id = static_cast<uint32_t>(rows.size());
+        bool fit = recruit.isFitForService();
+        rows.push_back(std::move(recruit));
+        if (fitBitmap.size() * 64 < rows.size()) {
+            fitBitmap.push_back(0);
+        }
+        if (fit) {
+            markFit(id);
+        }
+        return id;
+    }
+
+    uint32_t addRecruit(std::string_view name, std::string_view birthDate) {
+        Recruit recruit;
+        recruit.name.assign(name);
+        recruit.birthDate.assign(birthDate);
+        return addRecruit(std::move(recruit));
+    }
+
+    //новая запись врача у существующего призывника; true, если он стал пригодным
+    bool addRecord(uint32_t id, std::string_view specialty, std::string_view category) {
+        rows[id].doctorRecords.emplace_back(specialty, category);
+        if (!isFitRecord(category)) {
+            return false;
+        }
+        size_t before = fitOrder.size();
+        markFit(id);
+        return fitOrder.size() != before;
+    }
+
+    size_t size() const { return rows.size(); }
+    const Recruit& operator[](uint32_t id) const { return rows[id]; }
+
+    size_t fitCount() const { return fitOrder.size(); }
+    bool isFit(uint32_t id) const { return fitBitmap[id / 64] >> (id % 64) & 1; }
+
+    //отметка для fitSince: число пригодных на текущий момент
+    size_t fitVersion() const { return fitOrder.size(); }
+
+    //ставшие пригодными после отметки version, за O(изменений)
+    std::span<const uint32_t> fitSince(size_t version) const {
+        return std::span<const uint32_t>(fitOrder).subspan(version);
+    }
+
+    //все пригодные по возрастанию номера, по готовой битовой карте
+    SelectionVector selection() const { return bitmapToSelection(fitBitmap); }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "recruit_selection.h"
+#include <algorithm>
+#include <span>
+
+//индекс по году рождения: номера строк, разложенные по годам (CSR),
+//внутри года - по возрастанию. Строки с неразобранной датой в индекс не входят
+class BirthYearIndex {
+private:
+    int minYear = 0;
+    std::vector<uint32_t> yearOffsets{0};
+    std::vector<uint32_t> rows;
+
+public:
+    static BirthYearIndex build(const RecruitColumns& columns) {
+        BirthYearIndex index;
+        std::vector<int> years(columns.size());
+        int minYear = INT32_MAX;
+        int maxYear = INT32_MIN;
+
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (columns.birthDays[i] == INVALID_BIRTH_DAY) {
+                years[i] = INT32_MIN;
+                continue;
+            }
+            years[i] = yearFromBirthDay(columns.birthDays[i]);
+            minYear = std::min(minYear, years[i]);
+            maxYear = std::max(maxYear, years[i]);
+        }
+        if (minYear > maxYear) {
+            return index;
+        }
+
+        index.minYear = minYear;
+        index.yearOffsets.assign(maxYear - minYear + 2, 0);
+        for (int year : years) {
+            if (year != INT32_MIN) {
+                ++index.yearOffsets[year - minYear + 1];
+            }
+        }
+        for (size_t y = 1; y < index.yearOffsets.size(); ++y) {
+            index.yearOffsets[y] += index.yearOffsets[y - 1];
+        }
+
+        index.rows.resize(index.yearOffsets.back());
+        std::vector<uint32_t> cursor(index.yearOffsets.begin(), index.yearOffsets.end() - 1);
+        for (size_t i = 0; i < years.size(); ++i) {
+            if (years[i] != INT32_MIN) {
+                index.rows[cursor[years[i] - minYear]++] = static_cast<uint32_t>(i);
+            }
+        }
+        return index;
+    }
+
+    int firstYear() const { return minYear; }
+    int lastYear() const { return minYear + static_cast<int>(yearOffsets.size()) - 2; }
+
+    //строки, родившиеся в годы [fromYear, toYear]; упорядочены по году, затем по номеру
+    std::span<const uint32_t> rowsBornBetween(int fromYear, int toYear) const {
+        fromYear = std::max(fromYear, firstYear());
+        toYear = std::min(toYear, lastYear());
+        if (fromYear > toYear) {
+            return {};
+        }
+        uint32_t begin = yearOffsets[fromYear - minYear];
+        uint32_t end = yearOffsets[toYear - minYear + 1];
+        return std::span<const uint32_t>(rows).subspan(begin, end - begin);
+    }
+};
+
+namespace index_detail {
+    inline bool isFit(const std::vector<uint64_t>& fitBitmap, uint32_t row) {
+        return (fitBitmap[row / 64] >> (row % 64)) & 1;
+    }
+
+    //строки идут по годам, внутри года по возрастанию, а SelectionVector
+    //упорядочен по номеру строки. Сортируется только результат: O(k log k)
+    //от числа совпадений, а не проход по всей таблице. Если год один, он уже упорядочен
+    inline void sortIfSeveralYears(SelectionVector& selection, int fromYear, int toYear) {
+        if (fromYear != toYear) {
+            std::sort(selection.begin(), selection.end());
+        }
+    }
+}
+
+//пригодные, родившиеся в годы [fromYear, toYear]: обходятся только строки этих
+//лет из индекса, пригодность берётся из готовой битовой карты по номеру строки
+inline SelectionVector selectFitBornBetweenYears(const BirthYearIndex& index, const std::vector<uint64_t>& fitBitmap,
+                                                 int fromYear, int toYear) {
+    SelectionVector selection;
+    for (uint32_t row : index.rowsBornBetween(fromYear, toYear)) {
+        if (index_detail::isFit(fitBitmap, row)) {
+            selection.push_back(row);
+        }
+    }
+    index_detail::sortIfSeveralYears(selection, fromYear, toYear);
+    return selection;
+}
+
+//то же с точностью до дня: день сверяется с колонкой birthDays только у крайних лет
+inline SelectionVector selectFitBornBetween(const RecruitColumns& columns, const BirthYearIndex& index,
+                                            const std::vector<uint64_t>& fitBitmap,
+                                            uint32_t fromDay, uint32_t toDay) {
+    if (fromDay > toDay) {
+        return {};
+    }
+
+    int fromYear = yearFromBirthDay(fromDay);
+    int toYear = yearFromBirthDay(toDay);
+    SelectionVector selection;
+
+    for (int year : {fromYear, toYear}) {
+        for (uint32_t row : index.rowsBornBetween(year, year)) {
+            uint32_t day = columns.birthDays[row];
+            if (day >= fromDay && day <= toDay && index_detail::isFit(fitBitmap, row)) {
+                selection.push_back(row);
+            }
+        }
+        if (fromYear == toYear) break;
+    }
+    for (uint32_t row : index.rowsBornBetween(fromYear + 1, toYear - 1)) {
+        if (index_detail::isFit(fitBitmap, row)) {
+            selection.push_back(row);
+        }
+    }
+
+    index_detail::sortIfSeveralYears(selection, fromYear, toYear);
+    return selection;
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "recruit.h"
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
+#include <thread>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//файл, отображённый в память только для чтения
+class MappedFile {
+private:
+    const char* mappedData = nullptr;
+    size_t mappedSize = 0;
+    bool opened = false;
+
+    void release() {
+        if (mappedData != nullptr) {
+            munmap(const_cast<char*>(mappedData), mappedSize);
+        }
+        mappedData = nullptr;
+        mappedSize = 0;
+        opened = false;
+    }
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            mappedSize = static_cast<size_t>(info.st_size);
+            if (mappedSize == 0) {
+                opened = true;
+            } else {
+                void* addr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    madvise(addr, mappedSize, MADV_SEQUENTIAL);
+                    mappedData = static_cast<const char*>(addr);
+                    opened = true;
+                } else {
+                    mappedSize = 0;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : mappedData(other.mappedData), mappedSize(other.mappedSize), opened(other.opened) {
+        other.mappedData = nullptr;
+        other.mappedSize = 0;
+        other.opened = false;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            std::swap(mappedData, other.mappedData);
+            std::swap(mappedSize, other.mappedSize);
+            std::swap(opened, other.opened);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        release();
+    }
+
+    bool isOpen() const { return opened; }
+    std::string_view data() const { return {mappedData, mappedSize}; }
+};
+
+//те же пробельные символы, что пропускает operator>> в локали "C"
+inline bool isRecruitSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+inline std::string_view nextRecruitToken(const char*& pos, const char* end) {
+    while (pos < end && isRecruitSpace(*pos)) {
+        ++pos;
+    }
+    const char* start = pos;
+    while (pos < end && !isRecruitSpace(*pos)) {
+        ++pos;
+    }
+    return {start, static_cast<size_t>(pos - start)};
+}
+
+//разбор текста на месте с теми же правилами, что у readRecruitsFromFile:
+//строка без имени или даты пропускается, непарный хвост отбрасывается.
+//sink.addRecruit(name, birthDate) вызывается на каждого призывника,
+//sink.addRecord(specialty, category) - на каждую запись врача последнего из них
+template <typename Sink>
+void parseRecruitText(std::string_view text, Sink& sink) {
+    const char* pos = text.data();
+    const char* end = pos + text.size();
+
+    while (pos < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        const char* cursor = pos;
+        std::string_view name = nextRecruitToken(cursor, lineEnd);
+        std::string_view birthDate = nextRecruitToken(cursor, lineEnd);
+
+        if (!birthDate.empty()) {
+            sink.addRecruit(name, birthDate);
+            while (true) {
+                std::string_view specialty = nextRecruitToken(cursor, lineEnd);
+                std::string_view category = nextRecruitToken(cursor, lineEnd);
+                if (category.empty()) {
+                    break;
+                }
+                sink.addRecord(specialty, category);
+            }
+        }
+
+        pos = lineEnd + 1;
+    }
+}
+
+struct RecruitRecordRef {
+    std::string_view specialty;
+    std::string_view category;
+};
+
+struct RecruitRef {
+    std::string_view name;
+    std::string_view birthDate;
+    uint32_t firstRecord;
+    uint32_t recordCount;
+};
+
+//призывники в виде ссылок на отображённый файл, без копирования строк
+struct MappedRecruits {
+    MappedFile file;
+    std::vector<RecruitRef> recruits;
+    std::vector<RecruitRecordRef> records;
+
+    void addRecruit(std::string_view name, std::string_view birthDate) {
+        recruits.push_back({name, birthDate, static_cast<uint32_t>(records.size()), 0});
+    }
+
+    void addRecord(std::string_view specialty, std::string_view category) {
+        records.push_back({specialty, category});
+        ++recruits.back().recordCount;
+    }
+
+    size_t size() const { return recruits.size(); }
+
+    Recruit recruit(size_t index) const {
+        const RecruitRef& ref = recruits[index];
+        Recruit result;
+        result.name.assign(ref.name);
+        result.birthDate.assign(ref.birthDate);
+        result.doctorRecords.reserve(ref.recordCount);
+        for (uint32_t i = 0; i < ref.recordCount; ++i) {
+            const RecruitRecordRef& record = records[ref.firstRecord + i];
+            result.doctorRecords.emplace_back(record.specialty, record.category);
+        }
+        return result;
+    }
+};
+
+inline MappedRecruits loadRecruitsMapped(const std::string& filename) {
+    MappedRecruits result;
+    result.file = MappedFile(filename);
+
+    if (!result.file.isOpen()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return result;
+    }
+
+    parseRecruitText(result.file.data(), result);
+    return result;
+}
+
+//собирает Recruit прямо из отображённого буфера, без istringstream;
+//Vector - std::vector<Recruit> или std::pmr::vector<Recruit>
+template <typename Vector>
+struct RecruitVectorSink {
+    Vector& recruits;
+
+    void addRecruit(std::string_view name, std::string_view birthDate) {
+        Recruit& recruit = recruits.emplace_back();
+        recruit.name.assign(name);
+        recruit.birthDate.assign(birthDate);
+    }
+
+    void addRecord(std::string_view specialty, std::string_view category) {
+        recruits.back().doctorRecords.emplace_back(specialty, category);
+    }
+};
+
+inline std::vector<Recruit> readRecruitsFromFileMapped(const std::string& filename) {
+    std::vector<Recruit> recruits;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return recruits;
+    }
+
+    RecruitVectorSink sink{recruits};
+    parseRecruitText(file.data(), sink);
+    return recruits;
+}
+
+//разбиение текста на numChunks диапазонов, границы выровнены по концу строки
+inline std::vector<std::string_view> splitRecruitText(std::string_view text, int numChunks) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+
+    for (int i = 1; i <= numChunks && begin < text.size(); ++i) {
+        size_t end = text.size();
+        if (i < numChunks) {
+            end = std::max(begin, text.size() / numChunks * i);
+            size_t newline = text.find('\n', end);
+            end = (newline == std::string_view::npos) ? text.size() : newline + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    return chunks;
+}
+
+//многопоточное чтение: каждый поток разбирает свой диапазон байт,
+//результаты склеиваются в порядке следования в файле
+inline std::vector<Recruit> readRecruitsFromFileParallel(const std::string& filename, 
+                                                         int numThreads = std::thread::hardware_concurrency()) {
+    std::vector<Recruit> recruits;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return recruits;
+    }
+
+    std::vector<std::string_view> chunks = splitRecruitText(file.data(), std::max(numThreads, 1));
+    std::vector<std::vector<Recruit>> chunkResults(chunks.size());
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        threads.emplace_back([chunk = chunks[i], &result = chunkResults[i]]() {
+            RecruitVectorSink sink{result};
+            parseRecruitText(chunk, sink);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t totalSize = 0;
+    for (const auto& result : chunkResults) {
+        totalSize += result.size();
+    }
+    recruits.reserve(totalSize);
+
+    for (auto& result : chunkResults) {
+        recruits.insert(recruits.end(), 
+                        std::make_move_iterator(result.begin()), 
+                        std::make_move_iterator(result.end()));
+    }
+
+    return recruits;
+}
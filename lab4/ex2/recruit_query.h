@@ -0,0 +1,339 @@
+#pragma once
+
+#include "recruit_selection.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+//выражение-запрос над призывниками. Строится функциями hasRecord, specialtyIs,
+//categoryIs, bornBetween, recordCountBetween и операторами &&, ||, !,
+//затем компилируется под конкретные колонки в CompiledQuery
+class RecruitQuery {
+public:
+    enum class Kind { HasRecord, BornBetween, RecordCount, And, Or, Not };
+
+    struct Node {
+        Kind kind = Kind::HasRecord;
+        std::string specialty{};    //пустая строка - любая специальность
+        std::string category{};     //пустая строка - любая категория
+        uint32_t low = 0;
+        uint32_t high = 0;
+        std::shared_ptr<const Node> left{};
+        std::shared_ptr<const Node> right{};
+    };
+
+    explicit RecruitQuery(std::shared_ptr<const Node> node) : root(std::move(node)) {}
+
+    const Node& node() const { return *root; }
+    std::shared_ptr<const Node> share() const { return root; }
+
+    //эталонная построчная проверка, для сверки с скомпилированным запросом
+    bool matches(const Recruit& recruit) const { return matches(*root, recruit); }
+
+private:
+    std::shared_ptr<const Node> root;
+
+    static bool matches(const Node& node, const Recruit& recruit) {
+        switch (node.kind) {
+            case Kind::HasRecord:
+                for (const auto& record : recruit.doctorRecords) {
+                    if ((node.specialty.empty() || std::string_view(record.first) == node.specialty)
+                        && (node.category.empty() || std::string_view(record.second) == node.category)) {
+                        return true;
+                    }
+                }
+                return false;
+            case Kind::BornBetween: {
+                uint32_t day = parseBirthDate(recruit.birthDate);
+                return day != INVALID_BIRTH_DAY && day >= node.low && day <= node.high;
+            }
+            case Kind::RecordCount:
+                return recruit.doctorRecords.size() >= node.low && recruit.doctorRecords.size() <= node.high;
+            case Kind::And:
+                return matches(*node.left, recruit) && matches(*node.right, recruit);
+            case Kind::Or:
+                return matches(*node.left, recruit) || matches(*node.right, recruit);
+            case Kind::Not:
+                return !matches(*node.left, recruit);
+        }
+        return false;
+    }
+};
+
+//есть запись врача с такой специальностью и категорией
+inline RecruitQuery hasRecord(std::string_view specialty, std::string_view category) {
+    RecruitQuery::Node node{RecruitQuery::Kind::HasRecord, std::string(specialty), std::string(category)};
+    return RecruitQuery(std::make_shared<const RecruitQuery::Node>(std::move(node)));
+}
+
+inline RecruitQuery specialtyIs(std::string_view specialty) { return hasRecord(specialty, ""); }
+inline RecruitQuery categoryIs(std::string_view category) { return hasRecord("", category); }
+
+//год рождения в [fromYear, toYear]. Годы обрезаются до представимых датой:
+//день раньше 1900 года в uint32 не помещается. Диапазон целиком вне них пуст
+inline RecruitQuery bornBetween(int fromYear, int toYear) {
+    RecruitQuery::Node node{RecruitQuery::Kind::BornBetween};
+    fromYear = std::max(fromYear, BIRTH_EPOCH_YEAR);
+    toYear = std::min(toYear, BIRTH_LAST_YEAR);
+    if (fromYear > toYear) {
+        node.low = 1;
+        node.high = 0;
+    } else {
+        node.low = birthDay(fromYear, 1, 1);
+        node.high = birthDay(toYear, 12, 31);
+    }
+    return RecruitQuery(std::make_shared<const RecruitQuery::Node>(std::move(node)));
+}
+
+inline RecruitQuery recordCountBetween(uint32_t minCount, uint32_t maxCount) {
+    RecruitQuery::Node node{RecruitQuery::Kind::RecordCount};
+    node.low = minCount;
+    node.high = maxCount;
+    return RecruitQuery(std::make_shared<const RecruitQuery::Node>(std::move(node)));
+}
+
+inline RecruitQuery operator&&(const RecruitQuery& a, const RecruitQuery& b) {
+    RecruitQuery::Node node{RecruitQuery::Kind::And};
+    node.left = a.share();
+    node.right = b.share();
+    return RecruitQuery(std::make_shared<const RecruitQuery::Node>(std::move(node)));
+}
+
+inline RecruitQuery operator||(const RecruitQuery& a, const RecruitQuery& b) {
+    RecruitQuery::Node node{RecruitQuery::Kind::Or};
+    node.left = a.share();
+    node.right = b.share();
+    return RecruitQuery(std::make_shared<const RecruitQuery::Node>(std::move(node)));
+}
+
+inline RecruitQuery operator!(const RecruitQuery& a) {
+    RecruitQuery::Node node{RecruitQuery::Kind::Not};
+    node.left = a.share();
+    return RecruitQuery(std::make_shared<const RecruitQuery::Node>(std::move(node)));
+}
+
+//запрос, скомпилированный под колонки: строки специальностей и категорий
+//заменены кодами словаря, дерево - постфиксной программой. Программа
+//выполняется пакетами по BATCH строк, каждая инструкция обрабатывает
+//весь пакет в виде битовых слов, без ветвлений и вызовов на строку
+class CompiledQuery {
+private:
+    enum class Op : uint8_t { MatchRecord, BornBetween, RecordCount, Constant, And, Or, Not };
+
+    static constexpr int ANY = -1;
+    static constexpr size_t BATCH = 4096;
+    static constexpr size_t BATCH_WORDS = BATCH / 64;
+
+    struct Instruction {
+        Op op;
+        int specialty = ANY;
+        int category = ANY;
+        uint32_t low = 0;
+        uint32_t high = 0;
+    };
+
+    RecruitColumns columns;
+    std::vector<Instruction> program;
+    size_t stackDepth = 0;
+
+    //возвращает глубину стека после узла
+    size_t compile(const RecruitQuery::Node& node, size_t depth) {
+        switch (node.kind) {
+            case RecruitQuery::Kind::HasRecord: {
+                Instruction instruction{Op::MatchRecord};
+                bool missing = false;
+                if (!node.specialty.empty()) {
+                    instruction.specialty = columns.specialties ? columns.specialties->find(node.specialty) : -1;
+                    missing |= instruction.specialty < 0;
+                }
+                if (!node.category.empty()) {
+                    instruction.category = columns.categories ? columns.categories->find(node.category) : -1;
+                    missing |= instruction.category < 0;
+                }
+                //значения нет в словаре - запись не найдётся ни у кого
+                program.push_back(missing ? Instruction{Op::Constant} : instruction);
+                break;
+            }
+            //пустой диапазон (low > high) не совпадает ни с чем, как и в matches();
+            //беззнаковая проверка в rangeBits на нём переполнилась бы
+            case RecruitQuery::Kind::BornBetween:
+            case RecruitQuery::Kind::RecordCount:
+                if (node.low > node.high) {
+                    program.push_back({Op::Constant});
+                } else {
+                    Op op = node.kind == RecruitQuery::Kind::BornBetween ? Op::BornBetween : Op::RecordCount;
+                    program.push_back({op, ANY, ANY, node.low, node.high});
+                }
+                break;
+            case RecruitQuery::Kind::And:
+            case RecruitQuery::Kind::Or:
+                compile(*node.left, depth);
+                compile(*node.right, depth + 1);
+                program.push_back({node.kind == RecruitQuery::Kind::And ? Op::And : Op::Or});
+                break;
+            case RecruitQuery::Kind::Not:
+                compile(*node.left, depth);
+                program.push_back({Op::Not});
+                break;
+        }
+        stackDepth = std::max(stackDepth, depth + 1);
+        return depth + 1;
+    }
+
+    //биты пакета [first, last) для записи врача с заданными кодами
+    void matchRecord(const Instruction& instruction, size_t first, size_t last,
+                     uint64_t* out, std::vector<uint64_t>& recordBits, std::vector<uint64_t>& scratch) const {
+        uint32_t base = columns.recordOffsets[first];
+        uint32_t recordCount = columns.recordOffsets[last] - base;
+        size_t words = recordCount / 64 + 1;
+        MatchCategoryFn match = fitnessKernel().match;
+
+        recordBits.assign(words, ~0ULL);
+        if (instruction.category != ANY) {
+            match(columns.categoryCodes.data() + base, recordCount, static_cast<uint8_t>(instruction.category), recordBits.data());
+        }
+        if (instruction.specialty != ANY) {
+            scratch.resize(words);
+            match(columns.specialtyCodes.data() + base, recordCount, static_cast<uint8_t>(instruction.specialty), scratch.data());
+            for (size_t w = 0; w < words; ++w) {
+                recordBits[w] &= scratch[w];
+            }
+        }
+
+        for (size_t wordStart = first; wordStart < last; wordStart += 64) {
+            size_t wordEnd = std::min(wordStart + 64, last);
+            uint64_t word = 0;
+            for (size_t i = wordStart; i < wordEnd; ++i) {
+                bool found = anyBitInRange(recordBits.data(), columns.recordOffsets[i] - base,
+                                           columns.recordOffsets[i + 1] - base);
+                word |= static_cast<uint64_t>(found) << (i - wordStart);
+            }
+            out[(wordStart - first) / 64] = word;
+        }
+    }
+
+    //условие на значение строки: value(i) в [low, high], без ветвлений; low <= high
+    template <typename Value>
+    static void rangeBits(size_t first, size_t last, uint32_t low, uint32_t high, uint64_t* out, Value value) {
+        for (size_t wordStart = first; wordStart < last; wordStart += 64) {
+            size_t wordEnd = std::min(wordStart + 64, last);
+            uint64_t word = 0;
+            for (size_t i = wordStart; i < wordEnd; ++i) {
+                uint32_t v = value(i);
+                word |= static_cast<uint64_t>((v - low) <= (high - low)) << (i - wordStart);
+            }
+            out[(wordStart - first) / 64] = word;
+        }
+    }
+
+public:
+    CompiledQuery(const RecruitQuery& query, const RecruitColumns& source) : columns(source) {
+        compile(query.node(), 0);
+    }
+
+    size_t size() const { return columns.size(); }
+    const RecruitColumns& source() const { return columns; }
+
+    //битовая карта строк [first, last), удовлетворяющих запросу; first кратен 64
+    void evaluate(size_t first, size_t last, uint64_t* bitmap) const {
+        std::vector<uint64_t> stack(stackDepth * BATCH_WORDS);
+        std::vector<uint64_t> recordBits;
+        std::vector<uint64_t> scratch;
+
+        for (size_t batchStart = first; batchStart < last; batchStart += BATCH) {
+            size_t batchEnd = std::min(batchStart + BATCH, last);
+            size_t words = (batchEnd - batchStart + 63) / 64;
+            size_t top = 0;
+
+            for (const Instruction& instruction : program) {
+                uint64_t* out = stack.data() + top * BATCH_WORDS;
+                switch (instruction.op) {
+                    case Op::MatchRecord:
+                        matchRecord(instruction, batchStart, batchEnd, out, recordBits, scratch);
+                        ++top;
+                        break;
+                    case Op::BornBetween:
+                        rangeBits(batchStart, batchEnd, instruction.low, instruction.high, out,
+                                  [this](size_t i) { return columns.birthDays[i]; });
+                        ++top;
+                        break;
+                    case Op::RecordCount:
+                        rangeBits(batchStart, batchEnd, instruction.low, instruction.high, out,
+                                  [this](size_t i) { return columns.recordCount(i); });
+                        ++top;
+                        break;
+                    case Op::Constant:
+                        std::fill(out, out + words, 0);
+                        ++top;
+                        break;
+                    case Op::And:
+                    case Op::Or: {
+                        uint64_t* a = stack.data() + (top - 2) * BATCH_WORDS;
+                        const uint64_t* b = stack.data() + (top - 1) * BATCH_WORDS;
+                        if (instruction.op == Op::And) {
+                            for (size_t w = 0; w < words; ++w) a[w] &= b[w];
+                        } else {
+                            for (size_t w = 0; w < words; ++w) a[w] |= b[w];
+                        }
+                        --top;
+                        break;
+                    }
+                    case Op::Not: {
+                        uint64_t* a = stack.data() + (top - 1) * BATCH_WORDS;
+                        for (size_t w = 0; w < words; ++w) a[w] = ~a[w];
+                        break;
+                    }
+                }
+            }
+
+            //отрицание выставляет биты за концом пакета, их нужно сбросить
+            size_t tail = (batchEnd - batchStart) % 64;
+            if (tail != 0) {
+                stack[words - 1] &= (1ULL << tail) - 1;
+            }
+            std::copy(stack.begin(), stack.begin() + words, bitmap + batchStart / 64);
+        }
+    }
+
+    std::vector<uint64_t> evaluate() const {
+        std::vector<uint64_t> bitmap((size() + 63) / 64);
+        evaluate(0, size(), bitmap.data());
+        return bitmap;
+    }
+};
+
+inline SelectionVector selectRecruitsSingleThread(const CompiledQuery& query) {
+    return bitmapToSelection(query.evaluate());
+}
+
+//многопоточный отбор по запросу: диапазоны потоков кратны 64 строкам
+inline SelectionVector selectRecruitsMultiThread(const CompiledQuery& query, int numThreads = 4) {
+    std::vector<uint64_t> bitmap((query.size() + 63) / 64);
+    std::vector<std::thread> threads;
+    size_t chunkWords = bitmap.size() / numThreads;
+
+    for (int i = 0; i < numThreads; ++i) {
+        size_t first = i * chunkWords * 64;
+        size_t last = (i == numThreads - 1) ? query.size() : std::min((i + 1) * chunkWords * 64, query.size());
+        if (first >= last) continue;
+
+        threads.emplace_back([&query, &bitmap, first, last]() {
+            query.evaluate(first, last, bitmap.data());
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return bitmapToSelection(bitmap);
+}
+
+inline std::vector<Recruit> filterRecruitsSingleThread(const CompiledQuery& query) {
+    return materialize(query.source(), selectRecruitsSingleThread(query));
+}
+
+inline std::vector<Recruit> filterRecruitsMultiThread(const CompiledQuery& query, int numThreads = 4) {
+    return materialize(query.source(), selectRecruitsMultiThread(query, numThreads));
+}
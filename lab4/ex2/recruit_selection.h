@@ -0,0 +1,241 @@
+#pragma once
+
+#include "recruit_table.h"
+#include "work_stealing_pool.h"
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+//номера подходящих строк исходной коллекции, по возрастанию
+using SelectionVector = std::vector<uint32_t>;
+
+inline SelectionVector bitmapToSelection(const std::vector<uint64_t>& bitmap) {
+    SelectionVector selection;
+    size_t total = 0;
+    for (uint64_t word : bitmap) {
+        total += std::popcount(word);
+    }
+    selection.reserve(total);
+
+    forEachSetBit(bitmap.data(), 0, bitmap.size(), [&](size_t i) {
+        selection.push_back(static_cast<uint32_t>(i));
+    });
+    return selection;
+}
+
+//однопоточная фильтрация с копированием пригодных
+inline std::vector<Recruit> filterRecruitsSingleThread(const std::vector<Recruit>& recruits) {
+    std::vector<Recruit> suitable;
+
+    for (const auto& recruit : recruits) {
+        if (recruit.isFitForService()) {
+            suitable.push_back(recruit);
+        }
+    }
+
+    return suitable;
+}
+
+//многопоточная фильтрация без глобального состояния и блокировок в два прохода:
+//потоки считают пригодных в своих диапазонах, после join вычисляются префиксные
+//суммы и результат выделяется точного размера, затем каждый поток копирует своих
+inline std::vector<Recruit> filterRecruitsMultiThread(const std::vector<Recruit>& recruits, int numThreads = 4) {
+    if (numThreads < 1) {
+        std::cerr << "Число потоков должно быть положительным: " << numThreads << std::endl;
+        return {};
+    }
+    if (recruits.empty()) return {};
+
+    std::vector<size_t> offsets(numThreads + 1, 0);
+    size_t chunkSize = recruits.size() / numThreads;
+    auto chunkStart = [&](int i) { return i * chunkSize; };
+    auto chunkEnd = [&](int i) { return (i == numThreads - 1) ? recruits.size() : (i + 1) * chunkSize; };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            size_t count = 0;
+            for (size_t r = chunkStart(i); r < chunkEnd(i); ++r) {
+                count += recruits[r].isFitForService();
+            }
+            offsets[i + 1] = count;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    std::vector<Recruit> suitable(offsets[numThreads]);
+
+    threads.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            size_t out = offsets[i];
+            for (size_t r = chunkStart(i); r < chunkEnd(i); ++r) {
+                if (recruits[r].isFitForService()) {
+                    suitable[out++] = recruits[r];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return suitable;
+}
+
+//однопоточный отбор без копирования призывников
+inline SelectionVector selectRecruitsSingleThread(const std::vector<Recruit>& recruits) {
+    SelectionVector selection;
+
+    for (size_t i = 0; i < recruits.size(); ++i) {
+        if (recruits[i].isFitForService()) {
+            selection.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    return selection;
+}
+
+//многопоточный отбор: каждый поток собирает номера своего диапазона,
+//результаты склеиваются по порядку, поэтому совпадают с однопоточными
+inline SelectionVector selectRecruitsMultiThread(const std::vector<Recruit>& recruits, int numThreads = 4) {
+    if (recruits.empty()) return {};
+
+    std::vector<std::thread> threads;
+    std::vector<SelectionVector> threadResults(numThreads);
+    size_t chunkSize = recruits.size() / numThreads;
+
+    for (int i = 0; i < numThreads; ++i) {
+        size_t start = i * chunkSize;
+        size_t end = (i == numThreads - 1) ? recruits.size() : (i + 1) * chunkSize;
+
+        threads.emplace_back([&recruits, start, end, &result = threadResults[i]]() {
+            for (size_t r = start; r < end; ++r) {
+                if (recruits[r].isFitForService()) {
+                    result.push_back(static_cast<uint32_t>(r));
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    SelectionVector selection;
+    size_t totalSize = 0;
+    for (const auto& result : threadResults) {
+        totalSize += result.size();
+    }
+    selection.reserve(totalSize);
+
+    for (const auto& result : threadResults) {
+        selection.insert(selection.end(), result.begin(), result.end());
+    }
+
+    return selection;
+}
+
+inline SelectionVector selectRecruitsSingleThread(const RecruitColumns& columns) {
+    return bitmapToSelection(columns.fitnessBitmap());
+}
+
+//многопоточный отбор по колонкам: потоки строят свои части битовой карты
+inline SelectionVector selectRecruitsMultiThread(const RecruitColumns& columns, int numThreads = 4) {
+    std::vector<uint64_t> bitmap((columns.size() + 63) / 64);
+    std::vector<std::thread> threads;
+    size_t chunkWords = bitmap.size() / numThreads;
+
+    for (int i = 0; i < numThreads; ++i) {
+        size_t first = i * chunkWords * 64;
+        size_t last = (i == numThreads - 1) ? columns.size() : std::min((i + 1) * chunkWords * 64, columns.size());
+        if (first >= last) continue;
+
+        threads.emplace_back([&columns, &bitmap, first, last]() {
+            columns.fitnessBitmap(first, last, bitmap.data());
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return bitmapToSelection(bitmap);
+}
+
+inline SelectionVector selectRecruitsSingleThread(const RecruitTable& table) {
+    return selectRecruitsSingleThread(table.columns());
+}
+
+inline SelectionVector selectRecruitsMultiThread(const RecruitTable& table, int numThreads = 4) {
+    return selectRecruitsMultiThread(table.columns(), numThreads);
+}
+
+//отбор на постоянном пуле: морселы по morselSize строк, у каждого свой
+//результат, склейка по порядку морселов
+inline SelectionVector selectRecruitsPool(WorkStealingPool& pool, const std::vector<Recruit>& recruits,
+                                          size_t morselSize = 16384) {
+    if (recruits.empty()) return {};
+
+    std::vector<SelectionVector> morselResults((recruits.size() + morselSize - 1) / morselSize);
+    pool.parallelFor(recruits.size(), morselSize, [&](size_t begin, size_t end) {
+        SelectionVector& result = morselResults[begin / morselSize];
+        for (size_t r = begin; r < end; ++r) {
+            if (recruits[r].isFitForService()) {
+                result.push_back(static_cast<uint32_t>(r));
+            }
+        }
+    });
+
+    SelectionVector selection;
+    size_t totalSize = 0;
+    for (const auto& result : morselResults) {
+        totalSize += result.size();
+    }
+    selection.reserve(totalSize);
+
+    for (const auto& result : morselResults) {
+        selection.insert(selection.end(), result.begin(), result.end());
+    }
+
+    return selection;
+}
+
+//сужение выборки дополнительным условием: pred(i) получает номер строки
+template <typename Pred>
+SelectionVector refineSelection(const SelectionVector& selection, Pred pred) {
+    SelectionVector refined;
+    refined.reserve(selection.size());
+
+    for (uint32_t i : selection) {
+        if (pred(i)) {
+            refined.push_back(i);
+        }
+    }
+
+    return refined;
+}
+
+//копирование выбранных призывников, только когда они действительно нужны
+inline std::vector<Recruit> materialize(const std::vector<Recruit>& recruits, const SelectionVector& selection) {
+    std::vector<Recruit> result;
+    result.reserve(selection.size());
+    for (uint32_t i : selection) {
+        result.push_back(recruits[i]);
+    }
+    return result;
+}
+
+inline std::vector<Recruit> materialize(const RecruitColumns& columns, const SelectionVector& selection) {
+    std::vector<Recruit> result;
+    result.reserve(selection.size());
+    for (uint32_t i : selection) {
+        result.push_back(columns.recruit(i));
+    }
+    return result;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "recruit_table.h"
+#include <array>
+
+//параллельная агрегация: каждый поток копит собственный частичный агрегат
+//по своему диапазону строк, без атомиков и общих счётчиков, а после join
+//частичные агрегаты сливаются. Aggregate должен иметь конструктор от
+//RecruitColumns, addRange(columns, first, last) с first, кратным 64, и merge
+template <typename Aggregate>
+Aggregate aggregateRecruits(const RecruitColumns& columns, int numThreads = 4) {
+    size_t words = (columns.size() + 63) / 64;
+    size_t chunkWords = words / numThreads;
+    std::vector<Aggregate> partials;
+    partials.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        partials.emplace_back(columns);
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        size_t first = i * chunkWords * 64;
+        size_t last = (i == numThreads - 1) ? columns.size() : std::min((i + 1) * chunkWords * 64, columns.size());
+        if (first >= last) continue;
+
+        threads.emplace_back([&columns, &partials, i, first, last]() {
+            //частичный агрегат копится в локальной копии, чтобы соседние
+            //агрегаты в partials не делили кэш-линии во время прохода
+            Aggregate local(columns);
+            local.addRange(columns, first, last);
+            partials[i] = std::move(local);
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Aggregate result(columns);
+    for (const auto& partial : partials) {
+        result.merge(partial);
+    }
+    return result;
+}
+
+//сводка по призывникам за один проход: пригодность по году рождения,
+//категории по специальностям и число записей врачей на призывника
+struct RecruitReport {
+    static constexpr int YEARS = 256;    //годы BIRTH_EPOCH_YEAR .. BIRTH_EPOCH_YEAR + 255
+
+    size_t total = 0;
+    size_t fit = 0;
+    size_t unknownBirthYear = 0;
+    std::array<size_t, YEARS> bornInYear{};
+    std::array<size_t, YEARS> fitInYear{};
+    size_t specialtyCount = 0;
+    size_t categoryCount = 0;
+    std::vector<size_t> categoryBySpecialty;    //specialtyCount x categoryCount
+    std::vector<size_t> recordsPerRecruit;      //гистограмма: призывников с k записями
+
+    explicit RecruitReport(const RecruitColumns& columns)
+        : specialtyCount(columns.specialties ? columns.specialties->size() : 0),
+          categoryCount(columns.categories ? columns.categories->size() : 0),
+          categoryBySpecialty(specialtyCount * categoryCount) {}
+
+    void addRange(const RecruitColumns& columns, size_t first, size_t last) {
+        constexpr size_t BLOCK = 4096;
+        std::vector<uint64_t> fitBits(BLOCK / 64);
+
+        for (size_t blockStart = first; blockStart < last; blockStart += BLOCK) {
+            size_t blockEnd = std::min(blockStart + BLOCK, last);
+            //пригодность считается SIMD-ядром сразу для блока; карта отсчитывается от начала блока
+            std::fill(fitBits.begin(), fitBits.end(), 0);
+            if (columns.fitCategory >= 0) {
+                computeCategoryBitmap(columns.recordOffsets.data() + blockStart, columns.categoryCodes.data(),
+                                      static_cast<uint8_t>(columns.fitCategory), 0, blockEnd - blockStart,
+                                      fitBits.data(), fitnessKernel().match);
+            }
+
+            for (size_t i = blockStart; i < blockEnd; ++i) {
+                size_t offset = i - blockStart;
+                size_t isFit = fitBits[offset / 64] >> (offset % 64) & 1;
+                fit += isFit;
+
+                uint32_t day = columns.birthDays[i];
+                int year = day == INVALID_BIRTH_DAY ? -1 : yearFromBirthDay(day) - BIRTH_EPOCH_YEAR;
+                if (year >= 0 && year < YEARS) {
+                    ++bornInYear[year];
+                    fitInYear[year] += isFit;
+                } else {
+                    ++unknownBirthYear;
+                }
+
+                uint32_t records = columns.recordCount(i);
+                if (records >= recordsPerRecruit.size()) {
+                    recordsPerRecruit.resize(records + 1);
+                }
+                ++recordsPerRecruit[records];
+            }
+        }
+
+        for (uint32_t r = columns.recordOffsets[first]; r < columns.recordOffsets[last]; ++r) {
+            ++categoryBySpecialty[columns.specialtyCodes[r] * categoryCount + columns.categoryCodes[r]];
+        }
+        total += last - first;
+    }
+
+    void merge(const RecruitReport& other) {
+        total += other.total;
+        fit += other.fit;
+        unknownBirthYear += other.unknownBirthYear;
+        for (int y = 0; y < YEARS; ++y) {
+            bornInYear[y] += other.bornInYear[y];
+            fitInYear[y] += other.fitInYear[y];
+        }
+        for (size_t k = 0; k < categoryBySpecialty.size(); ++k) {
+            categoryBySpecialty[k] += other.categoryBySpecialty[k];
+        }
+        if (other.recordsPerRecruit.size() > recordsPerRecruit.size()) {
+            recordsPerRecruit.resize(other.recordsPerRecruit.size());
+        }
+        for (size_t k = 0; k < other.recordsPerRecruit.size(); ++k) {
+            recordsPerRecruit[k] += other.recordsPerRecruit[k];
+        }
+    }
+
+    size_t born(int year) const {
+        int index = year - BIRTH_EPOCH_YEAR;
+        return index >= 0 && index < YEARS ? bornInYear[index] : 0;
+    }
+
+    double fitRate(int year) const {
+        int index = year - BIRTH_EPOCH_YEAR;
+        if (index < 0 || index >= YEARS || bornInYear[index] == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(fitInYear[index]) / bornInYear[index];
+    }
+
+    size_t categoryCountFor(uint8_t specialty, uint8_t category) const {
+        return categoryBySpecialty[specialty * categoryCount + category];
+    }
+};
+
+inline RecruitReport buildRecruitReport(const RecruitColumns& columns, int numThreads = 4) {
+    return aggregateRecruits<RecruitReport>(columns, numThreads);
+}
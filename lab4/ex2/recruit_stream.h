@@ -0,0 +1,213 @@
+#pragma once
+
+#include "recruit_loader.h"
+#include "../ring_buffer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <sys/resource.h>
+
+//ограниченная очередь без блокировок для нескольких писателей и читателей
+//поверх MpmcRingBuffer, с закрытием и ожиданием; capacity кольцо округляет
+//вверх до степени двойки
+template <typename T>
+class BoundedQueue {
+private:
+    MpmcRingBuffer<T> ring;
+    alignas(64) std::atomic<bool> closed{false};
+
+public:
+    explicit BoundedQueue(size_t capacity) : ring(capacity) {}
+
+    //ждёт свободного места: так медленный потребитель притормаживает писателя
+    void push(T value) {
+        while (!ring.tryPush(std::move(value))) {
+            std::this_thread::yield();
+        }
+    }
+
+    //false, если очередь закрыта и пуста
+    bool pop(T& value) {
+        while (!ring.tryPop(value)) {
+            if (closed.load(std::memory_order_acquire)) {
+                return ring.tryPop(value);
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void close() { closed.store(true, std::memory_order_release); }
+};
+
+struct TextBatch {
+    size_t sequence = 0;
+    std::string text;
+};
+
+struct FilteredBatch {
+    size_t sequence = 0;
+    std::string text;
+    size_t recruits = 0;
+    size_t suitable = 0;
+};
+
+struct StreamStats {
+    size_t bytesRead = 0;
+    size_t recruitsRead = 0;
+    size_t recruitsSuitable = 0;
+    long long milliseconds = 0;
+    long peakRssKb = 0;
+    bool succeeded = false;    //всё прочитано и записано без ошибок
+};
+
+inline void appendRecruitLine(std::string& out, const Recruit& recruit) {
+    out += recruit.name;
+    out += ' ';
+    out += recruit.birthDate;
+    for (const auto& record : recruit.doctorRecords) {
+        out += ' ';
+        out += record.first;
+        out += ' ';
+        out += record.second;
+    }
+    out += '\n';
+}
+
+//потоковая фильтрация: читатель режет файл на пакеты по batchBytes, выровненные
+//по строкам, рабочие разбирают и фильтруют их, приёмник пишет пригодных
+//в outputFile в исходном порядке. Число пакетов в обработке ограничено
+//семафором, поэтому пиковая память не зависит от размера входа
+inline StreamStats streamFilterRecruits(const std::string& inputFile, const std::string& outputFile,
+                                        int numWorkers = std::thread::hardware_concurrency(),
+                                        size_t batchBytes = 1 << 20, size_t queueCapacity = 8) {
+    StreamStats stats;
+    std::ifstream input(inputFile, std::ios::binary);
+    std::ofstream output(outputFile, std::ios::binary);
+
+    if (!input.is_open()) {
+        std::cerr << "Ошибка открытия файла: " << inputFile << std::endl;
+        return stats;
+    }
+    if (!output.is_open()) {
+        std::cerr << "Ошибка создания файла: " << outputFile << std::endl;
+        return stats;
+    }
+
+    numWorkers = std::max(numWorkers, 1);
+    BoundedQueue<TextBatch> textQueue(queueCapacity);
+    BoundedQueue<FilteredBatch> filteredQueue(queueCapacity);
+    std::counting_semaphore<> inFlight(static_cast<std::ptrdiff_t>(queueCapacity * 2 + numWorkers));
+    std::atomic<int> activeWorkers{numWorkers};
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread reader([&]() {
+        std::string carry;
+        size_t sequence = 0;
+
+        while (true) {
+            std::string block = std::move(carry);
+            carry.clear();
+            size_t old = block.size();
+            block.resize(old + batchBytes);
+            input.read(block.data() + old, batchBytes);
+            size_t got = static_cast<size_t>(input.gcount());
+            block.resize(old + got);
+            stats.bytesRead += got;
+
+            if (got == 0) {
+                if (!block.empty()) {
+                    inFlight.acquire();
+                    textQueue.push({sequence++, std::move(block)});
+                }
+                break;
+            }
+
+            size_t lastNewline = block.rfind('\n');
+            if (lastNewline == std::string::npos) {
+                carry = std::move(block);
+                continue;
+            }
+            carry.assign(block, lastNewline + 1);
+            block.resize(lastNewline + 1);
+
+            inFlight.acquire();
+            textQueue.push({sequence++, std::move(block)});
+        }
+
+        textQueue.close();
+    });
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.emplace_back([&]() {
+            std::vector<Recruit> recruits;
+            TextBatch batch;
+
+            while (textQueue.pop(batch)) {
+                recruits.clear();
+                RecruitVectorSink sink{recruits};
+                parseRecruitText(batch.text, sink);
+
+                FilteredBatch filtered;
+                filtered.sequence = batch.sequence;
+                filtered.recruits = recruits.size();
+                for (const auto& recruit : recruits) {
+                    if (recruit.isFitForService()) {
+                        appendRecruitLine(filtered.text, recruit);
+                        ++filtered.suitable;
+                    }
+                }
+                filteredQueue.push(std::move(filtered));
+            }
+
+            if (activeWorkers.fetch_sub(1) == 1) {
+                filteredQueue.close();
+            }
+        });
+    }
+
+    //приёмник: пакеты приходят не по порядку, пишутся строго по номеру
+    std::map<size_t, FilteredBatch> pending;
+    size_t nextSequence = 0;
+    FilteredBatch filtered;
+    while (filteredQueue.pop(filtered)) {
+        pending.emplace(filtered.sequence, std::move(filtered));
+        for (auto it = pending.find(nextSequence); it != pending.end(); it = pending.find(nextSequence)) {
+            output.write(it->second.text.data(), it->second.text.size());
+            stats.recruitsRead += it->second.recruits;
+            stats.recruitsSuitable += it->second.suitable;
+            pending.erase(it);
+            ++nextSequence;
+            inFlight.release();
+        }
+    }
+
+    reader.join();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    //ошибка записи (например, нет места) не прерывает конвейер, но результат неполон
+    output.flush();
+    bool written = output.good();
+    output.close();
+    stats.succeeded = written && !output.fail();
+    if (!stats.succeeded) {
+        std::cerr << "Ошибка записи в файл: " << outputFile << std::endl;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats.peakRssKb = usage.ru_maxrss;
+    }
+
+    return stats;
+}
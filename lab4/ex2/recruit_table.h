@@ -0,0 +1,259 @@
+#pragma once
+
+#include "recruit_loader.h"
+#include "fitness_kernel.h"
+#include "recruit_dates.h"
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+//словарь коротких строк: каждой строке присваивается код 0..255
+class StringDictionary {
+private:
+    std::vector<std::string> values;
+
+public:
+    int find(std::string_view value) const {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] == value) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    uint8_t intern(std::string_view value) {
+        int code = find(value);
+        if (code >= 0) {
+            return static_cast<uint8_t>(code);
+        }
+        if (values.size() > UINT8_MAX) {
+            throw std::length_error("StringDictionary: больше 256 различных значений");
+        }
+        values.emplace_back(value);
+        return static_cast<uint8_t>(values.size() - 1);
+    }
+
+    const std::string& operator[](uint8_t code) const { return values[code]; }
+    size_t size() const { return values.size(); }
+};
+
+//невладеющее представление колонок; строится RecruitTable::columns()
+struct RecruitColumns {
+    std::span<const uint32_t> recordOffsets;   //size() + 1, CSR по записям врачей
+    std::span<const uint8_t> specialtyCodes;
+    std::span<const uint8_t> categoryCodes;
+    std::span<const uint64_t> nameOffsets;     //size() + 1
+    std::string_view names;
+    std::span<const uint64_t> dateOffsets;     //size() + 1
+    std::string_view dates;
+    std::span<const uint32_t> birthDays;       //size(), parseBirthDate(birthDate(i))
+    const StringDictionary* specialties = nullptr;
+    const StringDictionary* categories = nullptr;
+    int fitCategory = -1;                      //код категории "A" или -1
+
+    size_t size() const { return recordOffsets.empty() ? 0 : recordOffsets.size() - 1; }
+
+    std::string_view name(size_t index) const {
+        return names.substr(nameOffsets[index], nameOffsets[index + 1] - nameOffsets[index]);
+    }
+
+    std::string_view birthDate(size_t index) const {
+        return dates.substr(dateOffsets[index], dateOffsets[index + 1] - dateOffsets[index]);
+    }
+
+    uint32_t recordCount(size_t index) const {
+        return recordOffsets[index + 1] - recordOffsets[index];
+    }
+
+    bool isFitForService(size_t index) const {
+        if (fitCategory < 0) {
+            return false;
+        }
+        for (uint32_t r = recordOffsets[index]; r < recordOffsets[index + 1]; ++r) {
+            if (categoryCodes[r] == fitCategory) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //битовая карта пригодности призывников [first, last), first кратен 64
+    void fitnessBitmap(size_t first, size_t last, uint64_t* bitmap,
+                       MatchCategoryFn match = fitnessKernel().match) const {
+        if (fitCategory < 0) {
+            std::fill(bitmap + first / 64, bitmap + (last + 63) / 64, 0);
+            return;
+        }
+        computeCategoryBitmap(recordOffsets.data(), categoryCodes.data(), static_cast<uint8_t>(fitCategory),
+                              first, last, bitmap, match);
+    }
+
+    std::vector<uint64_t> fitnessBitmap() const {
+        std::vector<uint64_t> bitmap((size() + 63) / 64);
+        fitnessBitmap(0, size(), bitmap.data());
+        return bitmap;
+    }
+
+    Recruit recruit(size_t index) const {
+        Recruit result;
+        result.name.assign(name(index));
+        result.birthDate.assign(birthDate(index));
+        result.doctorRecords.reserve(recordCount(index));
+        for (uint32_t r = recordOffsets[index]; r < recordOffsets[index + 1]; ++r) {
+            result.doctorRecords.emplace_back((*specialties)[specialtyCodes[r]], (*categories)[categoryCodes[r]]);
+        }
+        return result;
+    }
+};
+
+//колоночное хранилище призывников: коды специальностей и категорий,
+//плоские массивы записей врачей и общие буферы имён и дат
+class RecruitTable {
+private:
+    std::vector<uint32_t> recordOffsets{0};
+    std::vector<uint8_t> specialtyCodes;
+    std::vector<uint8_t> categoryCodes;
+    std::vector<uint64_t> nameOffsets{0};
+    std::string names;
+    std::vector<uint64_t> dateOffsets{0};
+    std::string dates;
+    std::vector<uint32_t> birthDays;
+    StringDictionary specialties;
+    StringDictionary categories;
+
+public:
+    void addRecruit(std::string_view name, std::string_view birthDate) {
+        names.append(name);
+        nameOffsets.push_back(names.size());
+        dates.append(birthDate);
+        dateOffsets.push_back(dates.size());
+        birthDays.push_back(parseBirthDate(birthDate));
+        recordOffsets.push_back(recordOffsets.back());
+    }
+
+    void addRecord(std::string_view specialty, std::string_view category) {
+        specialtyCodes.push_back(specialties.intern(specialty));
+        categoryCodes.push_back(categories.intern(category));
+        ++recordOffsets.back();
+    }
+
+    void add(const Recruit& recruit) {
+        addRecruit(recruit.name, recruit.birthDate);
+        for (const auto& record : recruit.doctorRecords) {
+            addRecord(record.first, record.second);
+        }
+    }
+
+    static RecruitTable fromRecruits(const std::vector<Recruit>& recruits) {
+        RecruitTable table;
+        table.recordOffsets.reserve(recruits.size() + 1);
+        table.nameOffsets.reserve(recruits.size() + 1);
+        table.dateOffsets.reserve(recruits.size() + 1);
+        table.birthDays.reserve(recruits.size());
+        for (const auto& recruit : recruits) {
+            table.add(recruit);
+        }
+        return table;
+    }
+
+    RecruitColumns columns() const {
+        RecruitColumns view;
+        view.recordOffsets = recordOffsets;
+        view.specialtyCodes = specialtyCodes;
+        view.categoryCodes = categoryCodes;
+        view.nameOffsets = nameOffsets;
+        view.names = names;
+        view.dateOffsets = dateOffsets;
+        view.dates = dates;
+        view.birthDays = birthDays;
+        view.specialties = &specialties;
+        view.categories = &categories;
+        view.fitCategory = categories.find("A");
+        return view;
+    }
+
+    size_t size() const { return recordOffsets.size() - 1; }
+    Recruit recruit(size_t index) const { return columns().recruit(index); }
+};
+
+inline RecruitTable loadRecruitTable(const std::string& filename) {
+    RecruitTable table;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return table;
+    }
+
+    parseRecruitText(file.data(), table);
+    return table;
+}
+
+//однопоточная фильтрация: битовая карта пригодности считается SIMD-ядром
+inline std::vector<Recruit> filterRecruitsSingleThread(const RecruitColumns& columns) {
+    std::vector<uint64_t> bitmap = columns.fitnessBitmap();
+    std::vector<Recruit> suitable;
+
+    forEachSetBit(bitmap.data(), 0, bitmap.size(), [&](size_t i) {
+        suitable.push_back(columns.recruit(i));
+    });
+
+    return suitable;
+}
+
+//многопоточная фильтрация: каждый поток строит свою часть битовой карты,
+//границы диапазонов кратны 64, поэтому потоки пишут в разные слова
+inline std::vector<Recruit> filterRecruitsMultiThread(const RecruitColumns& columns, int numThreads = 4) {
+    if (columns.size() == 0) return {};
+
+    std::vector<uint64_t> bitmap((columns.size() + 63) / 64);
+    std::vector<std::thread> threads;
+    std::vector<std::vector<Recruit>> threadResults(numThreads);
+    size_t chunkWords = bitmap.size() / numThreads;
+
+    for (int i = 0; i < numThreads; ++i) {
+        size_t firstWord = i * chunkWords;
+        size_t lastWord = (i == numThreads - 1) ? bitmap.size() : (i + 1) * chunkWords;
+
+        threads.emplace_back([&columns, &bitmap, firstWord, lastWord, &result = threadResults[i]]() {
+            size_t first = firstWord * 64;
+            size_t last = std::min(lastWord * 64, columns.size());
+            if (first >= last) return;
+
+            columns.fitnessBitmap(first, last, bitmap.data());
+            forEachSetBit(bitmap.data(), firstWord, lastWord, [&](size_t r) {
+                result.push_back(columns.recruit(r));
+            });
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<Recruit> suitable;
+    size_t totalSize = 0;
+    for (const auto& result : threadResults) {
+        totalSize += result.size();
+    }
+    suitable.reserve(totalSize);
+
+    for (auto& result : threadResults) {
+        suitable.insert(suitable.end(),
+                        std::make_move_iterator(result.begin()),
+                        std::make_move_iterator(result.end()));
+    }
+
+    return suitable;
+}
+
+inline std::vector<Recruit> filterRecruitsSingleThread(const RecruitTable& table) {
+    return filterRecruitsSingleThread(table.columns());
+}
+
+inline std::vector<Recruit> filterRecruitsMultiThread(const RecruitTable& table, int numThreads = 4) {
+    return filterRecruitsMultiThread(table.columns(), numThreads);
+}
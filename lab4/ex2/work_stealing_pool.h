@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//постоянный пул потоков с воровством работы: у каждого потока своя очередь
+//морселов, свободный поток забирает работу с хвоста чужой очереди
+class WorkStealingPool {
+private:
+    struct Job {
+        std::function<void(size_t, size_t)> body;
+        std::atomic<size_t> remaining{0};
+    };
+
+    //задание держится shared_ptr, чтобы последний морсел мог разбудить
+    //вызывающий поток, не обращаясь к уже уничтоженному заданию
+    struct Morsel {
+        std::shared_ptr<Job> job;
+        size_t begin;
+        size_t end;
+    };
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Morsel> morsels;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pendingMorsels{0};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    bool stopping = false;
+
+    //свой поток берёт морселы с головы (по порядку строк)
+    bool popLocal(size_t id, Morsel& morsel) {
+        WorkerQueue& queue = *queues[id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.morsels.empty()) return false;
+        morsel = queue.morsels.front();
+        queue.morsels.pop_front();
+        return true;
+    }
+
+    //чужие очереди обходятся начиная с соседа, морсел берётся с хвоста
+    bool steal(size_t id, Morsel& morsel) {
+        for (size_t k = 1; k < queues.size(); ++k) {
+            WorkerQueue& queue = *queues[(id + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.morsels.empty()) {
+                morsel = queue.morsels.back();
+                queue.morsels.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(const Morsel& morsel) {
+        morsel.job->body(morsel.begin, morsel.end);
+        if (morsel.job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            morsel.job->remaining.notify_all();
+        }
+    }
+
+    void workerLoop(size_t id) {
+        while (true) {
+            Morsel morsel;
+            if (popLocal(id, morsel) || steal(id, morsel)) {
+                pendingMorsels.fetch_sub(1, std::memory_order_relaxed);
+                run(morsel);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCv.wait(lock, [this] { return stopping || pendingMorsels.load() > 0; });
+            if (stopping && pendingMorsels.load() == 0) return;
+        }
+    }
+
+public:
+    explicit WorkStealingPool(int numThreads = std::thread::hardware_concurrency()) {
+        numThreads = std::max(numThreads, 1);
+        for (int i = 0; i < numThreads; ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (int i = 0; i < numThreads; ++i) {
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    //body(begin, end) вызывается для каждого морсела [0, count) размером morselSize;
+    //морселы раздаются потокам непрерывными полосами, возврат - после выполнения всех
+    void parallelFor(size_t count, size_t morselSize, std::function<void(size_t, size_t)> body) {
+        if (count == 0) return;
+        morselSize = std::max<size_t>(morselSize, 1);
+
+        auto job = std::make_shared<Job>();
+        job->body = std::move(body);
+        size_t numMorsels = (count + morselSize - 1) / morselSize;
+        job->remaining.store(numMorsels, std::memory_order_relaxed);
+        pendingMorsels.fetch_add(numMorsels);
+
+        size_t perQueue = (numMorsels + queues.size() - 1) / queues.size();
+        for (size_t q = 0; q < queues.size(); ++q) {
+            size_t firstMorsel = q * perQueue;
+            size_t lastMorsel = std::min(firstMorsel + perQueue, numMorsels);
+            if (firstMorsel >= lastMorsel) break;
+
+            std::lock_guard<std::mutex> lock(queues[q]->mutex);
+            for (size_t m = firstMorsel; m < lastMorsel; ++m) {
+                queues[q]->morsels.push_back({job, m * morselSize, std::min((m + 1) * morselSize, count)});
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleepCv.notify_all();
+
+        size_t left = job->remaining.load(std::memory_order_acquire);
+        while (left != 0) {
+            job->remaining.wait(left, std::memory_order_acquire);
+            left = job->remaining.load(std::memory_order_acquire);
+        }
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//гистограмма задержек в духе HDR: на каждую степень двойки 32 корзины,
+//то есть относительная погрешность не больше 1/32. Запись - один инкремент
+//без атомиков, поэтому у каждого потока своя гистограмма, сливаемая после замера
+class LatencyHistogram {
+private:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    std::array<uint64_t, BUCKETS> counts{};
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        unsigned shift = std::bit_width(value) - 1 - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    //верхняя граница значений корзины
+    static uint64_t bucketUpperBound(size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS - 1);
+        uint64_t sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    void record(uint64_t value) {
+        ++counts[bucketOf(value)];
+        ++total;
+        maxValue = value > maxValue ? value : maxValue;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        maxValue = other.maxValue > maxValue ? other.maxValue : maxValue;
+    }
+
+    void clear() { *this = LatencyHistogram(); }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+
+    //значение, не меньше которого оказалась доля fraction записей (0.99 - p99)
+    uint64_t percentile(double fraction) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t bound = bucketUpperBound(i);
+                return bound < maxValue ? bound : maxValue;
+            }
+        }
+        return maxValue;
+    }
+};
+
+struct LatencyReport {
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+    uint64_t samples = 0;
+    //индекс Джайна: 1 - поровну, 1/n - всё досталось одному потоку;
+    //пусто, если захватов слишком мало, чтобы о честности можно было судить
+    std::optional<double> fairness;
+};
+
+//задержки захвата по потокам. Честность считается по доле своих захватов,
+//которую каждый поток успел сделать до момента, когда первый поток закончил
+//работу: пока все конкурируют, честный примитив двигает потоки вперёд поровну.
+//Доля, а не число захватов, потому что потоки могут по замыслу захватывать
+//разное число раз (потребитель MPSC разбирает всё, что произвели остальные).
+//Всего захватов потока за прогон - его план: все операции когда-нибудь выполняются
+class LatencyRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct alignas(64) ThreadState {
+        LatencyHistogram histogram;
+        uint64_t contendedAcquisitions = 0;
+        uint64_t acquisitions = 0;
+    };
+
+    //меньше захватов на поток - доля меняется скачками и индекс ничего не говорит
+    //(поток с одним захватом делает всю свою работу разом). Не судим о честности
+    //и тогда, когда до конца окна захватывал только один поток: остальные ещё
+    //не начали, соревнования не было (короткие прогоны на одном ядре)
+    static constexpr uint64_t MIN_FAIRNESS_ACQUISITIONS = 32;
+
+    std::vector<ThreadState> threads;
+    alignas(64) std::atomic<bool> someoneFinished{false};
+    //чтение часов само стоит десятки наносекунд, поэтому замер пропускной
+    //способности лучше делать отдельным прогоном с выключенной записью
+    bool enabled = true;
+
+public:
+    explicit LatencyRecorder(int numThreads) : threads(numThreads) {}
+
+    void setEnabled(bool value) { enabled = value; }
+
+    Clock::time_point waitStart() const { return enabled ? Clock::now() : Clock::time_point{}; }
+
+    //перед каждым прогоном: окно честности открывается заново
+    void startRun() { someoneFinished.store(false, std::memory_order_relaxed); }
+
+    //захват состоялся; waitStart - момент перед попыткой захвата
+    void acquired(int thread, Clock::time_point waitStart) {
+        if (!enabled) {
+            return;
+        }
+        auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - waitStart);
+        ThreadState& state = threads[thread];
+        state.histogram.record(static_cast<uint64_t>(waited.count()));
+        state.contendedAcquisitions += !someoneFinished.load(std::memory_order_relaxed);
+        ++state.acquisitions;
+    }
+
+    void finished() { someoneFinished.store(true, std::memory_order_relaxed); }
+
+    void clear() {
+        for (auto& state : threads) {
+            state = ThreadState();
+        }
+    }
+
+    LatencyReport report() const {
+        LatencyHistogram merged;
+        double sum = 0;
+        double sumSquares = 0;
+        size_t participants = 0;
+        size_t competitors = 0;
+        bool enoughAcquisitions = true;
+        for (const auto& state : threads) {
+            merged.merge(state.histogram);
+            if (state.acquisitions == 0) {
+                continue;
+            }
+            ++participants;
+            competitors += state.contendedAcquisitions > 0;
+            enoughAcquisitions &= state.acquisitions >= MIN_FAIRNESS_ACQUISITIONS;
+            double share = static_cast<double>(state.contendedAcquisitions) / static_cast<double>(state.acquisitions);
+            sum += share;
+            sumSquares += share * share;
+        }
+
+        LatencyReport result;
+        result.p50 = merged.percentile(0.50);
+        result.p99 = merged.percentile(0.99);
+        result.p999 = merged.percentile(0.999);
+        result.max = merged.max();
+        result.samples = merged.count();
+        if (competitors >= 2 && enoughAcquisitions) {
+            result.fairness = sum * sum / (static_cast<double>(participants) * sumSquares);
+        }
+        return result;
+    }
+};
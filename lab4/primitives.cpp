@@ -11,18 +11,30 @@
 #include <iomanip>
 #include <functional>
 #include <algorithm>
+#include <array>
+#include "thread_harness.h"
+#include "latency_histogram.h"
+#include "ring_buffer.h"
+#include "barriers.h"
 
 using namespace std;
 
 constexpr int THREAD_COUNT = 8;
 constexpr int ITERATIONS = 100000; 
-constexpr int BARRIER_ITERATIONS = 1000;
 constexpr int ASCII_START = 32; 
 constexpr int ASCII_END = 126;
+constexpr size_t CACHE_LINE = 64;
+constexpr int SHARD_COUNT = 4;
+constexpr int BATCH_SIZE = 64;
+constexpr size_t QUEUE_CAPACITY = 1024;
+constexpr int BARRIER_SCALING_THREADS[] = {4, 8, 16, 32, 64};
 
 vector<char> shared_buffer;
 mutex buffer_mutex;
 
+//ожидание захвата по каждой операции; wait_start берётся перед попыткой захвата
+LatencyRecorder latency(THREAD_COUNT);
+
 char get_random_char() {
     thread_local random_device rd;
     thread_local mt19937 gen(rd());
@@ -31,18 +43,22 @@ char get_random_char() {
 }
 
 //Мьютекс
-void mutex_worker(int iters) {
+void mutex_worker(int thread_id, int iters) {
     for (int i = 0; i < iters; ++i) {
+        auto wait_start = latency.waitStart();
         lock_guard<mutex> lock(buffer_mutex);
+        latency.acquired(thread_id, wait_start);
         shared_buffer.push_back(get_random_char());
     }
 }
 
 //Семафор
 counting_semaphore<> sem(1);
-void semaphore_worker(int iters) {
+void semaphore_worker(int thread_id, int iters) {
     for (int i = 0; i < iters; ++i) {
+        auto wait_start = latency.waitStart();
         sem.acquire();
+        latency.acquired(thread_id, wait_start);
         shared_buffer.push_back(get_random_char());
         sem.release();
     }
@@ -50,11 +66,13 @@ void semaphore_worker(int iters) {
 
 //Спинлок
 atomic_flag spinlock = ATOMIC_FLAG_INIT;
-void spinlock_worker(int iters) {
+void spinlock_worker(int thread_id, int iters) {
     for (int i = 0; i < iters; ++i) {
+        auto wait_start = latency.waitStart();
         while (spinlock.test_and_set(memory_order_acquire)) {
             std::this_thread::yield(); 
         }
+        latency.acquired(thread_id, wait_start);
         shared_buffer.push_back(get_random_char());
         spinlock.clear(memory_order_release);
     }
@@ -62,11 +80,13 @@ void spinlock_worker(int iters) {
 
 //Спинвейт
 atomic<bool> busy_flag{false};
-void spinwait_worker(int iters) {
+void spinwait_worker(int thread_id, int iters) {
     for (int i = 0; i < iters; ++i) {
+        auto wait_start = latency.waitStart();
         while (busy_flag.exchange(true, memory_order_acquire)) {
              std::this_thread::yield();
         }
+        latency.acquired(thread_id, wait_start);
         shared_buffer.push_back(get_random_char());
         busy_flag.store(false, memory_order_release);
     }
@@ -77,10 +97,12 @@ mutex monitor_mtx;
 condition_variable monitor_cv;
 bool resource_free = true;
 
-void monitor_worker(int iters) {
+void monitor_worker(int thread_id, int iters) {
     for (int i = 0; i < iters; ++i) {
+        auto wait_start = latency.waitStart();
         unique_lock<mutex> lock(monitor_mtx);
         monitor_cv.wait(lock, [] { return resource_free; });
+        latency.acquired(thread_id, wait_start);
         
         resource_free = false;
         lock.unlock(); 
@@ -93,61 +115,286 @@ void monitor_worker(int iters) {
     }
 }
 
-//Барьер
-barrier<> sync_barrier(THREAD_COUNT);
+//Барьер: std::barrier и собственные реализации из barriers.h
+StdBarrier sync_barrier(THREAD_COUNT);
+SenseBarrier sense_barrier(THREAD_COUNT);
+DisseminationBarrier dissemination_barrier(THREAD_COUNT);
+TournamentBarrier tournament_barrier(THREAD_COUNT);
 mutex barrier_mutex_internal;
 
-void barrier_worker(int iters) {
+//для барьера «захват» - выход из arriveAndWait
+template<typename Barrier>
+void barrier_worker(Barrier& phase_barrier, int thread_id, int iters) {
     for (int i = 0; i < iters; ++i) {
         {
             lock_guard<mutex> lock(barrier_mutex_internal);
             shared_buffer.push_back(get_random_char());
         }
-        sync_barrier.arrive_and_wait(); 
+        auto wait_start = latency.waitStart();
+        phase_barrier.arriveAndWait(thread_id);
+        latency.acquired(thread_id, wait_start);
+    }
+}
+
+//Варианты без захвата общей блокировки на каждый символ. Итог всё равно
+//собирается в shared_buffer, и сборка входит в замер
+
+//Локальные буферы: поток пишет в свой буфер и один раз сливает его в общий.
+//Выравнивание по кэш-линии, чтобы push_back соседей не сбивали одну линию
+struct alignas(CACHE_LINE) LocalBuffer {
+    vector<char> chars;
+};
+vector<LocalBuffer> local_buffers(THREAD_COUNT);
+
+void local_buffer_worker(int thread_id, int iters) {
+    vector<char>& local = local_buffers[thread_id].chars;
+    local.clear();
+    local.reserve(iters);
+    for (int i = 0; i < iters; ++i) {
+        local.push_back(get_random_char());
     }
+    auto wait_start = latency.waitStart();
+    lock_guard<mutex> lock(buffer_mutex);
+    latency.acquired(thread_id, wait_start);
+    shared_buffer.insert(shared_buffer.end(), local.begin(), local.end());
 }
 
+//Шарды: SHARD_COUNT буферов со своими мьютексами, поток пишет в шард
+//thread_id % SHARD_COUNT. После барьера шарды сливаются в общий буфер
+struct alignas(CACHE_LINE) BufferShard {
+    mutex lock;
+    vector<char> chars;
+};
+array<BufferShard, SHARD_COUNT> shards;
+barrier<> shard_barrier(THREAD_COUNT);
+
+void sharded_worker(int thread_id, int iters) {
+    BufferShard& shard = shards[thread_id % SHARD_COUNT];
+    for (int i = 0; i < iters; ++i) {
+        auto wait_start = latency.waitStart();
+        lock_guard<mutex> lock(shard.lock);
+        latency.acquired(thread_id, wait_start);
+        shard.chars.push_back(get_random_char());
+    }
+    shard_barrier.arrive_and_wait();
+    if (thread_id < SHARD_COUNT) {
+        lock_guard<mutex> lock(buffer_mutex);
+        shared_buffer.insert(shared_buffer.end(), shard.chars.begin(), shard.chars.end());
+        shard.chars.clear();
+    }
+}
+
+//Пакеты: BATCH_SIZE символов готовятся вне блокировки и дописываются за один захват
+void batched_worker(int thread_id, int iters) {
+    array<char, BATCH_SIZE> batch;
+    for (int i = 0; i < iters; i += BATCH_SIZE) {
+        int size = min(BATCH_SIZE, iters - i);
+        for (int k = 0; k < size; ++k) {
+            batch[k] = get_random_char();
+        }
+        auto wait_start = latency.waitStart();
+        lock_guard<mutex> lock(buffer_mutex);
+        latency.acquired(thread_id, wait_start);
+        shared_buffer.insert(shared_buffer.end(), batch.begin(), batch.begin() + size);
+    }
+}
+
+//Очереди: производители передают символы потребителям через lock-free кольцо.
+//Элемент - номер символа и сам символ, по номеру проверяется, что каждый
+//символ доставлен ровно один раз. Всего символов THREAD_COUNT * iters, как и в
+//остальных вариантах; «захват» - успешная запись или чтение
+static_assert(THREAD_COUNT % 2 == 0, "MPMC: потоки делятся поровну на производителей и потребителей");
+
+DeliveryCheck delivery(static_cast<size_t>(THREAD_COUNT) * ITERATIONS);
+
+uint64_t make_item(int index) { return static_cast<uint64_t>(index) << 8 | static_cast<uint8_t>(get_random_char()); }
+
+template<typename Queue>
+void push_item(Queue& queue, int thread_id, uint64_t item) {
+    auto wait_start = latency.waitStart();
+    while (!queue.tryPush(item)) {
+        std::this_thread::yield();
+    }
+    latency.acquired(thread_id, wait_start);
+}
+
+template<typename Queue>
+char pop_item(Queue& queue, int thread_id) {
+    uint64_t item;
+    auto wait_start = latency.waitStart();
+    while (!queue.tryPop(item)) {
+        std::this_thread::yield();
+    }
+    latency.acquired(thread_id, wait_start);
+    delivery.mark(item >> 8);
+    return static_cast<char>(item & 0xFF);
+}
+
+//MPSC: поток 0 - потребитель и единственный писатель shared_buffer, остальные производят
+MpscRingBuffer<uint64_t> mpsc_queue(QUEUE_CAPACITY);
+
+void mpsc_worker(int thread_id, int iters) {
+    int total = THREAD_COUNT * iters;
+    if (thread_id == 0) {
+        for (int i = 0; i < total; ++i) {
+            shared_buffer.push_back(pop_item(mpsc_queue, thread_id));
+        }
+        return;
+    }
+    for (int index = thread_id - 1; index < total; index += THREAD_COUNT - 1) {
+        push_item(mpsc_queue, thread_id, make_item(index));
+    }
+}
+
+//MPMC: чётные потоки производят, нечётные потребляют в локальные буферы
+//и в конце сливают их в общий
+MpmcRingBuffer<uint64_t> mpmc_queue(QUEUE_CAPACITY);
+
+void mpmc_worker(int thread_id, int iters) {
+    constexpr int PAIRS = THREAD_COUNT / 2;
+    int total = THREAD_COUNT * iters;
+    if (thread_id % 2 == 0) {
+        for (int index = thread_id / 2; index < total; index += PAIRS) {
+            push_item(mpmc_queue, thread_id, make_item(index));
+        }
+        return;
+    }
+    vector<char>& local = local_buffers[thread_id].chars;
+    local.clear();
+    local.reserve(total / PAIRS);
+    for (int i = 0; i < total / PAIRS; ++i) {
+        local.push_back(pop_item(mpmc_queue, thread_id));
+    }
+    lock_guard<mutex> lock(buffer_mutex);
+    shared_buffer.insert(shared_buffer.end(), local.begin(), local.end());
+}
+
+//потоки берутся из harness: создание и join не входят в замер
 template<typename Func>
-double run_and_measure(Func func, const string& name, int iter_count) {
-    shared_buffer.clear();
+double run_and_measure(ThreadHarness& harness, Func func, const string& name, int iter_count,
+                       DeliveryCheck* check = nullptr) {
     shared_buffer.reserve(THREAD_COUNT * iter_count);
     
-    vector<thread> threads;
-    threads.reserve(THREAD_COUNT);
-    
-    auto start = chrono::high_resolution_clock::now();
-    
-    for (int i = 0; i < THREAD_COUNT; ++i)
-        threads.emplace_back(func, iter_count);
+    //первый прогон - время без записи задержек, второй - задержки и честность
+    auto run_workers = [&](bool record_latency) {
+        shared_buffer.clear();
+        latency.clear();
+        latency.setEnabled(record_latency);
+        latency.startRun();
+        auto elapsed = harness.run([&func, iter_count](int thread_id) {
+            func(thread_id, iter_count);
+            latency.finished();
+        });
+        if (check) {
+            if (size_t errors = check->errors()) {
+                cerr << name << ": " << errors << " символов потеряно или доставлено повторно" << endl;
+            }
+            check->reset();
+        }
+        return elapsed;
+    };
+    auto elapsed = run_workers(false);
+    size_t count = shared_buffer.size();
+    run_workers(true);
+    double ms = chrono::duration<double, milli>(elapsed).count();
+    double operations = static_cast<double>(THREAD_COUNT) * iter_count;
     
-    for (auto& t : threads)
-        t.join();
+    cout << left << setw(13) << name 
+         << " | Time: " << setw(8) << fixed << setprecision(2) << ms << " ms"
+         << " | " << setw(8) << setprecision(1) << elapsed.count() / operations << " ns/op"
+         << " | " << setw(12) << setprecision(0) << operations / (ms / 1000) << " ops/s"
+         << " | Count: " << count << endl;
     
-    auto end = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+    LatencyReport report = latency.report();
+    cout << setw(13) << "" << " | Wait ns: p50 " << report.p50 << ", p99 " << report.p99 
+         << ", p99.9 " << report.p999 << ", max " << report.max 
+         << " | Fairness: ";
+    if (report.fairness) {
+        cout << setprecision(3) << *report.fairness << endl;
+    } else {
+        cout << "N/A" << endl;
+    }
+    cout.unsetf(ios::fixed);
     
-    cout << left << setw(12) << name 
-         << " | Time: " << setw(6) << duration.count() << " ms"
-         << " | Count: " << shared_buffer.size() << endl;
+    return ms;
+}
+
+//чистая стоимость фазы: iters проходов барьера без другой работы, нс на проход
+template<typename Barrier>
+double barrier_phase_ns(ThreadHarness& harness, int iters) {
+    Barrier phase_barrier(harness.size());
+    auto elapsed = harness.run([&phase_barrier, iters](int thread_id) {
+        for (int i = 0; i < iters; ++i) {
+            phase_barrier.arriveAndWait(thread_id);
+        }
+    });
+    return static_cast<double>(elapsed.count()) / iters;
+}
+
+void barrier_scaling(int iters) {
+    cout << "\nМасштабирование барьеров (" << iters << " фаз, нс на фазу)\n";
+    cout << left << setw(14) << "Threads";
+    for (int threads : BARRIER_SCALING_THREADS) {
+        cout << setw(10) << threads;
+    }
+    cout << "\n";
     
-    return duration.count();
+    vector<pair<string, vector<double>>> rows = {{"std::barrier", {}}, {"Sense", {}}, 
+                                                 {"Dissemination", {}}, {"Tournament", {}}};
+    for (int threads : BARRIER_SCALING_THREADS) {
+        ThreadHarness harness(threads);
+        rows[0].second.push_back(barrier_phase_ns<StdBarrier>(harness, iters));
+        rows[1].second.push_back(barrier_phase_ns<SenseBarrier>(harness, iters));
+        rows[2].second.push_back(barrier_phase_ns<DisseminationBarrier>(harness, iters));
+        rows[3].second.push_back(barrier_phase_ns<TournamentBarrier>(harness, iters));
+    }
+    for (const auto& [name, times] : rows) {
+        cout << setw(14) << name << fixed << setprecision(0);
+        for (double ns : times) {
+            cout << setw(10) << ns;
+        }
+        cout << "\n";
+    }
+    cout.unsetf(ios::fixed);
 }
 
 int main() {
     cout << "Анализ примитивов синхронизации (потоки: " << THREAD_COUNT << ") ===\n\n";
     
     vector<pair<string, double>> results;
+    ThreadHarness harness(THREAD_COUNT);
     
-    results.emplace_back("SpinLock", run_and_measure(spinlock_worker, "SpinLock", ITERATIONS));
-    results.emplace_back("SpinWait", run_and_measure(spinwait_worker, "SpinWait", ITERATIONS));
-    results.emplace_back("Mutex", run_and_measure(mutex_worker, "Mutex", ITERATIONS));
-    results.emplace_back("Semaphore", run_and_measure(semaphore_worker, "Semaphore", ITERATIONS));
-    results.emplace_back("Monitor", run_and_measure(monitor_worker, "Monitor", ITERATIONS));
+    results.emplace_back("SpinLock", run_and_measure(harness, spinlock_worker, "SpinLock", ITERATIONS));
+    results.emplace_back("SpinWait", run_and_measure(harness, spinwait_worker, "SpinWait", ITERATIONS));
+    results.emplace_back("Mutex", run_and_measure(harness, mutex_worker, "Mutex", ITERATIONS));
+    results.emplace_back("Semaphore", run_and_measure(harness, semaphore_worker, "Semaphore", ITERATIONS));
+    results.emplace_back("Monitor", run_and_measure(harness, monitor_worker, "Monitor", ITERATIONS));
     
-    cout << "Примечание: Метод барьера выполняет меньше итераций (" << BARRIER_ITERATIONS << ") из-за накладных расходов.\n";
-    double barrier_time = run_and_measure(barrier_worker, "Barrier", BARRIER_ITERATIONS);
-    double projected_barrier = barrier_time * (static_cast<double>(ITERATIONS) / BARRIER_ITERATIONS);
-    results.emplace_back("Barrier (est)", projected_barrier);
+    results.emplace_back("Barrier", run_and_measure(harness, [](int thread_id, int iters) {
+        barrier_worker(sync_barrier, thread_id, iters);
+    }, "Barrier", ITERATIONS));
+    results.emplace_back("Sense", run_and_measure(harness, [](int thread_id, int iters) {
+        barrier_worker(sense_barrier, thread_id, iters);
+    }, "Sense", ITERATIONS));
+    results.emplace_back("Dissemination", run_and_measure(harness, [](int thread_id, int iters) {
+        barrier_worker(dissemination_barrier, thread_id, iters);
+    }, "Dissemination", ITERATIONS));
+    results.emplace_back("Tournament", run_and_measure(harness, [](int thread_id, int iters) {
+        barrier_worker(tournament_barrier, thread_id, iters);
+    }, "Tournament", ITERATIONS));
+    
+    cout << "\nБез общей блокировки на каждую операцию (мьютекс; шардов: " << SHARD_COUNT 
+         << ", пакет: " << BATCH_SIZE << ")\n";
+    results.emplace_back("Per-thread", run_and_measure(harness, local_buffer_worker, "Per-thread", ITERATIONS));
+    results.emplace_back("Sharded", run_and_measure(harness, sharded_worker, "Sharded", ITERATIONS));
+    results.emplace_back("Batched", run_and_measure(harness, batched_worker, "Batched", ITERATIONS));
+    
+    cout << "\nLock-free очереди (ёмкость " << QUEUE_CAPACITY << "; MPSC: " << THREAD_COUNT - 1 
+         << " производителей и 1 потребитель, MPMC: " << THREAD_COUNT / 2 << " и " << THREAD_COUNT / 2 << ")\n";
+    results.emplace_back("MPSC queue", run_and_measure(harness, mpsc_worker, "MPSC queue", ITERATIONS, &delivery));
+    results.emplace_back("MPMC queue", run_and_measure(harness, mpmc_worker, "MPMC queue", ITERATIONS, &delivery));
+
+    barrier_scaling(ITERATIONS);
 
     cout << "\nСравнительные результаты (отсортированные по скорости)\n";
     sort(results.begin(), results.end(), 
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+//ограниченные lock-free очереди на кольцевом буфере. Ёмкость округляется вверх
+//до степени двойки, не меньше 2: позиция в кольце - pos & mask.
+//У каждой ячейки свой номер последовательности (по Вьюкову): он говорит, чей
+//сейчас ход в ячейке - писателя круга pos или читателя. Голова и хвост лежат
+//в разных кэш-линиях, чтобы производители и потребители не сбивали друг другу линию
+
+namespace ring_detail {
+    //при ёмкости 1 освобождённая ячейка (pos + mask + 1) получила бы тот же номер,
+    //что и заполненная (pos + 1), и чтение приняло бы пустую ячейку за полную
+    inline size_t roundCapacity(size_t capacity) { return std::bit_ceil(std::max<size_t>(capacity, 2)); }
+}
+
+//много производителей, много потребителей: обе стороны занимают позицию через CAS
+template <typename T>
+class MpmcRingBuffer {
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+
+public:
+    explicit MpmcRingBuffer(size_t requestedCapacity)
+        : mask(ring_detail::roundCapacity(requestedCapacity) - 1), cells(new Cell[mask + 1]) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+    MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    //false, если очередь полна; значение забирается только при успехе,
+    //поэтому неудачную попытку можно повторить с тем же value
+    template <typename U>
+    bool tryPush(U&& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //false, если очередь пуста
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+//много производителей, один потребитель: производители как в MPMC,
+//а голову двигает только потребитель, обычной записью без CAS
+template <typename T>
+class MpscRingBuffer {
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;
+
+public:
+    explicit MpscRingBuffer(size_t requestedCapacity)
+        : mask(ring_detail::roundCapacity(requestedCapacity) - 1), cells(new Cell[mask + 1]) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    template <typename U>
+    bool tryPush(U&& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //вызывается только из потока-потребителя
+    bool tryPop(T& value) {
+        Cell& cell = cells[dequeuePos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            return false;
+        }
+        value = std::move(cell.value);
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+};
+
+//проверка доставки: каждый элемент с номером index должен быть получен ровно один раз
+class DeliveryCheck {
+private:
+    size_t items;
+    std::unique_ptr<std::atomic<uint8_t>[]> delivered;
+
+public:
+    explicit DeliveryCheck(size_t count) : items(count), delivered(new std::atomic<uint8_t>[count]) {
+        reset();
+    }
+
+    void mark(size_t index) { delivered[index].fetch_add(1, std::memory_order_relaxed); }
+
+    //число потерянных и повторных элементов
+    size_t errors() const {
+        size_t result = 0;
+        for (size_t i = 0; i < items; ++i) {
+            result += delivered[i].load(std::memory_order_relaxed) != 1;
+        }
+        return result;
+    }
+
+    void reset() {
+        for (size_t i = 0; i < items; ++i) {
+            delivered[i].store(0, std::memory_order_relaxed);
+        }
+    }
+};
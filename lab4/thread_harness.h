@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//постоянный набор рабочих потоков для замеров: потоки создаются один раз
+//и ждут на стартовом барьере, поэтому создание и join не попадают в замер.
+//run() отпускает всех разом и возвращает время от первого старта до
+//последнего завершения тела, то есть только конкурентный участок
+class ThreadHarness {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int numThreads;
+    std::function<void(int)> body;
+    bool stopping = false;
+    std::vector<Clock::time_point> begins;
+    std::vector<Clock::time_point> ends;
+    std::barrier<> startLine;
+    std::barrier<> finishLine;
+    std::vector<std::thread> workers;
+
+    void workerLoop(int threadId) {
+        while (true) {
+            startLine.arrive_and_wait();
+            if (stopping) {
+                return;
+            }
+            begins[threadId] = Clock::now();
+            body(threadId);
+            ends[threadId] = Clock::now();
+            finishLine.arrive_and_wait();
+        }
+    }
+
+public:
+    explicit ThreadHarness(int threads)
+        : numThreads(threads), begins(threads), ends(threads),
+          startLine(threads + 1), finishLine(threads + 1) {
+        workers.reserve(threads);
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(&ThreadHarness::workerLoop, this, i);
+        }
+    }
+
+    ~ThreadHarness() {
+        stopping = true;
+        startLine.arrive_and_wait();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadHarness(const ThreadHarness&) = delete;
+    ThreadHarness& operator=(const ThreadHarness&) = delete;
+
+    int size() const { return numThreads; }
+
+    //body(threadId) выполняется на каждом рабочем потоке
+    std::chrono::nanoseconds run(std::function<void(int)> task) {
+        body = std::move(task);
+        startLine.arrive_and_wait();
+        finishLine.arrive_and_wait();
+
+        Clock::time_point first = *std::min_element(begins.begin(), begins.end());
+        Clock::time_point last = *std::max_element(ends.begin(), ends.end());
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(last - first);
+    }
+};